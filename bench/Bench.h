@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gltk::bench
+{
+    struct Result
+    {
+        std::string name;
+        std::int64_t iterations; // per repetition
+        double ns_per_op;        // of the fastest repetition
+        std::int64_t bytes_per_op; // input consumed by one op, for throughput, 0 when it does not apply
+    };
+
+    // keeps the compiler from optimizing away a value computed by a benchmark
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        #if defined(_MSC_VER)
+        const volatile T* sink{ &value };
+        (void)sink;
+        #else
+        asm volatile("" : : "r,m"(value) : "memory");
+        #endif
+    }
+
+    // the fastest of REPETITIONS runs is reported: noise (scheduling, frequency changes) only ever adds time, so
+    // the minimum is what stays comparable from one run to the next
+    constexpr int REPETITIONS{ 5 };
+
+    template <typename F>
+    Result Measure(const std::string& name, std::int64_t iterations, F&& op, std::int64_t bytes_per_op = 0)
+    {
+        // warm up caches and branch predictors
+        for (std::int64_t i{}; i < std::max<std::int64_t>(iterations / 10, 1); i++)
+        {
+            op();
+        }
+
+        double best_ns{ std::numeric_limits<double>::max() };
+        for (int repetition{}; repetition < REPETITIONS; repetition++)
+        {
+            auto start{ std::chrono::steady_clock::now() };
+            for (std::int64_t i{}; i < iterations; i++)
+            {
+                op();
+            }
+            std::chrono::duration<double, std::nano> elapsed{ std::chrono::steady_clock::now() - start };
+            best_ns = std::min(best_ns, elapsed.count());
+        }
+        return { name, iterations, best_ns / static_cast<double>(iterations), bytes_per_op };
+    }
+
+    // names go into the JSON output as is, so file names are reduced to characters that need no escaping
+    inline std::string FileBenchmarkName(std::string_view prefix, const std::filesystem::path& file)
+    {
+        std::string name{ prefix };
+        for (char c : file.filename().string())
+        {
+            bool safe{ (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '_' };
+            name += safe ? c : '_';
+        }
+        return name;
+    }
+
+    void RunCheckBenchmarks(std::vector<Result>& results);
+    void RunGLCheckBenchmarks(std::vector<Result>& results);
+    void RunGltfBenchmarks(std::vector<Result>& results, const std::vector<std::filesystem::path>& files); // and a generated file
+    void RunImageBenchmarks(std::vector<Result>& results, const std::vector<std::filesystem::path>& files); // and generated images
+    void RunStd140Benchmarks(std::vector<Result>& results);
+}
@@ -0,0 +1,77 @@
+#include <Bench.h>
+
+#include <gltk/Check.h>
+
+#include <iostream>
+#include <streambuf>
+
+namespace gltk::bench
+{
+    // swallows whatever is written to it, so reporting failures does not measure the terminal
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    static bool Fail(int i)
+    {
+        DoNotOptimize(i);
+        return i < 0; // always false, but the compiler cannot know
+    }
+
+    // measures the failure paths of gltk_Check (constructing the Crash, throw and catch, with and without formatting
+    // the report) and of gltk_Verify, next to their passing paths as a baseline
+    void RunCheckBenchmarks(std::vector<Result>& results)
+    {
+        constexpr std::int64_t ITERATIONS{ 100'000 };
+        constexpr std::int64_t PASS_ITERATIONS{ 10'000'000 };
+
+        int i{ 1 };
+        results.push_back(Measure("check/pass", PASS_ITERATIONS, [&i]()
+        {
+            gltk_Check(!Fail(i));
+        }));
+        results.push_back(Measure("verify/pass", PASS_ITERATIONS, [&i]()
+        {
+            DoNotOptimize(gltk_Verify(!Fail(i)));
+        }));
+
+        results.push_back(Measure("crash/construct", ITERATIONS, []()
+        {
+            Crash crash{ __FILE__, __LINE__, "benchmark" }; // captures the raw frames, as every failed check does
+            DoNotOptimize(crash.Message().size());
+        }));
+        results.push_back(Measure("crash/throw_catch", ITERATIONS, [&i]()
+        {
+            try
+            {
+                gltk_Check(Fail(i));
+            }
+            catch (const Crash& e)
+            {
+                DoNotOptimize(e.Message().size());
+            }
+        }));
+        results.push_back(Measure("crash/throw_catch_what", ITERATIONS / 100, [&i]()
+        {
+            try
+            {
+                gltk_Check(Fail(i));
+            }
+            catch (const Crash& e)
+            {
+                DoNotOptimize(e.What().size()); // symbolizes the stacktrace, the cost every crash used to pay
+            }
+        }));
+
+        NullBuffer null_buffer{};
+        std::streambuf* cerr_buffer{ std::cerr.rdbuf(&null_buffer) };
+        results.push_back(Measure("verify/fail", ITERATIONS, [&i]()
+        {
+            DoNotOptimize(gltk_Verify(Fail(i)));
+        }));
+        std::cerr.rdbuf(cerr_buffer);
+    }
+}
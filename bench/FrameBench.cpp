@@ -0,0 +1,900 @@
+#include <Headless.h>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <gltk/GLTK.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Renders scripted scenes into an offscreen render target for a fixed number of frames and reports frame time
+// statistics as JSON. Every frame ends with glFinish, so a frame time covers both the CPU and the GPU side.
+// Runs without a display (see HeadlessContext), e.g. under Mesa llvmpipe on GPU-less machines.
+
+namespace gltk::bench
+{
+    constexpr const char* STREAM_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "void main()\n"
+        "{\n"
+        "   gl_Position = vec4(aPos, 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* INSTANCED_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 15) in uint aInstance;\n"
+        "uniform float uTime;\n"
+        "void main()\n"
+        "{\n"
+        "   vec2 cell = vec2(float(aInstance % 64u), float(aInstance / 64u)) / 32.0 - 1.0 + 1.0 / 64.0;\n"
+        "   float a = uTime + float(aInstance);\n"
+        "   mat2 r = mat2(cos(a), sin(a), -sin(a), cos(a));\n"
+        "   gl_Position = vec4(cell + r * aPos.xy / 64.0, aPos.z, 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* CULLED_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "layout (location = 11) in mat4 aModel;\n"
+        "uniform mat4 uViewProj;\n"
+        "void main()\n"
+        "{\n"
+        "   gl_Position = uViewProj * aModel * vec4(aPos, 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* PLACED_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "uniform mat4 uViewProj;\n"
+        "uniform vec3 uOffset;\n"
+        "uniform vec3 uScale;\n"
+        "void main()\n"
+        "{\n"
+        "   gl_Position = uViewProj * vec4(uOffset + uScale * aPos, 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* TEXTURED_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "layout (location = 0) in vec2 aPos;\n"
+        "layout (location = 15) in uint aInstance;\n"
+        "out vec2 vUV;\n"
+        "flat out uint vImage;\n"
+        "void main()\n"
+        "{\n"
+        "   vec2 cell = vec2(float(aInstance % 32u), float(aInstance / 32u)) / 16.0 - 1.0 + 1.0 / 32.0;\n"
+        "   vUV = aPos * 0.5 + 0.5;\n"
+        "   vImage = aInstance % 64u;\n"
+        "   gl_Position = vec4(cell + aPos / 32.0, 0.0, 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* TEXTURED_FRAGMENT_SHADER_SOURCE{
+        "#version 330 core\n"
+        "uniform sampler2D uTexture;\n"
+        "in vec2 vUV;\n"
+        "out vec4 FragColor;\n"
+        "void main()\n"
+        "{\n"
+        "   FragColor = texture(uTexture, vUV);\n"
+        "}\n"
+    };
+    constexpr const char* TEXTURE_ARRAY_FRAGMENT_SHADER_SOURCE{
+        "#version 330 core\n"
+        "uniform sampler2DArray uTextures;\n"
+        "uniform vec4 uRects[64];\n"
+        "uniform float uLayers[64];\n"
+        "in vec2 vUV;\n"
+        "flat in uint vImage;\n"
+        "out vec4 FragColor;\n"
+        "void main()\n"
+        "{\n"
+        "   FragColor = texture(uTextures, vec3(uRects[vImage].xy + vUV * uRects[vImage].zw, uLayers[vImage]));\n"
+        "}\n"
+    };
+    constexpr const char* FRAGMENT_SHADER_SOURCE{
+        "#version 330 core\n"
+        "out vec4 FragColor;\n"
+        "void main()\n"
+        "{\n"
+        "   FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);\n"
+        "}\n"
+    };
+
+    static GLuint BuildProgram(const char* vertex_source, const char* fragment_source)
+    {
+        ProgramBuilder builder{};
+        gltk_Check(builder.Compile(GL_VERTEX_SHADER, vertex_source));
+        gltk_Check(builder.Compile(GL_FRAGMENT_SHADER, fragment_source));
+        GLuint program{ builder.Link() };
+        gltk_Check(program);
+        return program;
+    }
+
+    class Scene
+    {
+    public:
+        Scene() = default;
+        virtual ~Scene() noexcept = default;
+        Scene(const Scene&) = delete;
+        Scene(Scene&&) noexcept = delete;
+        Scene& operator=(const Scene&) = delete;
+        Scene& operator=(Scene&&) noexcept = delete;
+    public:
+        virtual const char* Name() const noexcept = 0;
+        virtual std::int64_t ItemsPerFrame() const noexcept = 0; // what the throughput is reported in (e.g. triangles)
+        virtual void Render(int frame) = 0;
+        virtual void ResetStats() {}                           // called once the warmup frames are done
+        virtual std::string ExtraJson() const { return {}; }  // additional fields of the scene result, comma first
+    };
+
+    // fill rate and per-frame overhead only
+    class ClearScene : public Scene
+    {
+    public:
+        const char* Name() const noexcept override { return "clear"; }
+        std::int64_t ItemsPerFrame() const noexcept override { return 1; }
+        void Render(int frame) override
+        {
+            float t{ static_cast<float>(frame % 256) / 255.0f };
+            gltk_GLCheck(glClearColor(t, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+        }
+    };
+
+    // triangles rewritten every frame through a StreamBuffer, one RenderQueue item each (merged into a multi-draw)
+    class StreamTrianglesScene : public Scene
+    {
+    public:
+        StreamTrianglesScene()
+            : m_program{ BuildProgram(STREAM_VERTEX_SHADER_SOURCE, FRAGMENT_SHADER_SOURCE) }
+            , m_stream{ GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE }
+            , m_vao{}
+            , m_queue{}
+        {
+            gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_stream.Buffer()));
+            gltk_GLCheck(glEnableVertexAttribArray(0));
+            gltk_GLCheck(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr));
+            gltk_GLCheck(glBindVertexArray(0));
+        }
+        ~StreamTrianglesScene() noexcept override
+        {
+            gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+            gltk_GLCheck(glDeleteProgram(m_program));
+        }
+    public:
+        const char* Name() const noexcept override { return "stream_triangles"; }
+        std::int64_t ItemsPerFrame() const noexcept override { return TRIANGLES; }
+        void Render(int frame) override
+        {
+            gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+            StreamRange range{ m_stream.Map(TRIANGLES * 3 * sizeof(glm::vec3), sizeof(glm::vec3)) };
+            glm::vec3* vertices{ static_cast<glm::vec3*>(range.data) };
+            float t{ static_cast<float>(frame) * 0.01f };
+            for (int i{}; i < TRIANGLES; i++)
+            {
+                glm::vec2 cell{ glm::vec2{ static_cast<float>(i % 64), static_cast<float>(i / 64) } / 32.0f - 1.0f + 1.0f / 64.0f };
+                for (int v{}; v < 3; v++)
+                {
+                    float a{ t + static_cast<float>(i) + static_cast<float>(v) * 2.0943951f };
+                    vertices[i * 3 + v] = glm::vec3{ cell + glm::vec2{ std::cos(a), std::sin(a) } / 64.0f, 0.0f };
+                }
+            }
+            m_stream.Unmap(range);
+
+            GLintptr first{ range.offset / static_cast<GLintptr>(sizeof(glm::vec3)) };
+            for (int i{}; i < TRIANGLES; i++)
+            {
+                m_queue.Submit({ .program = m_program, .vao = m_vao, .count = 3, .first = first + i * 3 });
+            }
+            m_queue.Flush();
+            m_stream.EndFrame();
+        }
+    private:
+        constexpr static int TRIANGLES{ 4096 };
+        constexpr static GLsizeiptr STREAM_BUFFER_SIZE{ 4 * 1024 * 1024 };
+    private:
+        GLuint m_program;
+        StreamBuffer m_stream;
+        GLuint m_vao;
+        RenderQueue m_queue;
+    };
+
+    // one static triangle drawn many times through the RenderQueue instancing path
+    class InstancedTrianglesScene : public Scene
+    {
+    public:
+        InstancedTrianglesScene()
+            : m_program{ BuildProgram(INSTANCED_VERTEX_SHADER_SOURCE, FRAGMENT_SHADER_SOURCE) }
+            , m_time_location{}
+            , m_vbo{}
+            , m_vao{}
+            , m_queue{}
+        {
+            gltk_GLCheck(m_time_location = glGetUniformLocation(m_program, "uTime"));
+
+            constexpr glm::vec3 VERTICES[]{ { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } };
+            gltk_GLCheck(glGenBuffers(1, &m_vbo));
+            gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+            gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, sizeof(VERTICES), VERTICES, GL_STATIC_DRAW));
+            gltk_GLCheck(glEnableVertexAttribArray(0));
+            gltk_GLCheck(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr));
+            gltk_GLCheck(glBindVertexArray(0));
+        }
+        ~InstancedTrianglesScene() noexcept override
+        {
+            gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+            gltk_GLCheck(glDeleteBuffers(1, &m_vbo));
+            gltk_GLCheck(glDeleteProgram(m_program));
+        }
+    public:
+        const char* Name() const noexcept override { return "instanced_triangles"; }
+        std::int64_t ItemsPerFrame() const noexcept override { return TRIANGLES; }
+        void Render(int frame) override
+        {
+            gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+            gltk_GLCheck(glUseProgram(m_program));
+            gltk_GLCheck(glUniform1f(m_time_location, static_cast<float>(frame) * 0.01f));
+            for (std::uint32_t i{}; i < TRIANGLES; i++)
+            {
+                m_queue.Submit({ .program = m_program, .vao = m_vao, .count = 3, .instance = i });
+            }
+            m_queue.Flush();
+        }
+    private:
+        constexpr static std::uint32_t TRIANGLES{ 4096 };
+    private:
+        GLuint m_program;
+        GLint m_time_location;
+        GLuint m_vbo;
+        GLuint m_vao;
+        RenderQueue m_queue;
+    };
+
+    // a large grid of cubes and pyramids seen by a spinning camera, frustum culled and drawn through SceneBuffer
+    class CulledInstancesScene : public Scene
+    {
+    public:
+        explicit CulledInstancesScene(bool indirect)
+            : m_program{ BuildProgram(CULLED_VERTEX_SHADER_SOURCE, FRAGMENT_SHADER_SOURCE) }
+            , m_view_proj_location{}
+            , m_vbo{}
+            , m_ebo{}
+            , m_vao{}
+            , m_pool{}
+            , m_scene{ &m_pool, indirect }
+            , m_name{ indirect ? "culled_instances_indirect" : "culled_instances_instanced" }
+            , m_frames{}
+            , m_visible{}
+            , m_draw_calls{}
+            , m_cull_time{}
+        {
+            gltk_GLCheck(m_view_proj_location = glGetUniformLocation(m_program, "uViewProj"));
+
+            // a cube and a pyramid in the same buffers, so that the indirect path merges them into one multi-draw
+            constexpr glm::vec3 VERTICES[]{
+                { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f },
+                { -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, 0.5f, 0.5f }, { -0.5f, 0.5f, 0.5f },
+                { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, 0.5f }, { -0.5f, -0.5f, 0.5f }, { 0.0f, 0.5f, 0.0f },
+            };
+            constexpr std::uint16_t INDICES[]{
+                0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4, 3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5,
+                0, 1, 2, 0, 2, 3, 0, 4, 1, 1, 4, 2, 2, 4, 3, 3, 4, 0,
+            };
+            gltk_GLCheck(glGenBuffers(1, &m_vbo));
+            gltk_GLCheck(glGenBuffers(1, &m_ebo));
+            gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+            gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, sizeof(VERTICES), VERTICES, GL_STATIC_DRAW));
+            gltk_GLCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+            gltk_GLCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(INDICES), INDICES, GL_STATIC_DRAW));
+            gltk_GLCheck(glEnableVertexAttribArray(0));
+            gltk_GLCheck(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr));
+            gltk_GLCheck(glBindVertexArray(0));
+
+            std::uint32_t meshes[]{
+                m_scene.AddMesh({ .vao = m_vao, .count = 36, .index_type = GL_UNSIGNED_SHORT, .first = 0, .radius = 0.8661f }),
+                m_scene.AddMesh({ .vao = m_vao, .count = 18, .index_type = GL_UNSIGNED_SHORT, .first = 36 * sizeof(std::uint16_t), .base_vertex = 8, .radius = 0.8661f }),
+            };
+            for (std::uint32_t i{}; i < GRID * GRID; i++)
+            {
+                glm::vec3 position{ (static_cast<float>(i % GRID) - GRID / 2.0f) * SPACING, 0.0f, (static_cast<float>(i / GRID) - GRID / 2.0f) * SPACING };
+                m_scene.AddInstance(meshes[i % 2], glm::translate(glm::mat4{ 1.0f }, position));
+            }
+        }
+        ~CulledInstancesScene() noexcept override
+        {
+            gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+            gltk_GLCheck(glDeleteBuffers(1, &m_ebo));
+            gltk_GLCheck(glDeleteBuffers(1, &m_vbo));
+            gltk_GLCheck(glDeleteProgram(m_program));
+        }
+    public:
+        const char* Name() const noexcept override { return m_name; }
+        std::int64_t ItemsPerFrame() const noexcept override { return GRID * GRID; }
+        void Render(int frame) override
+        {
+            gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+            gltk_GLCheck(glEnable(GL_DEPTH_TEST));
+
+            float angle{ static_cast<float>(frame) * 0.01f };
+            glm::vec3 eye{ 0.0f, 4.0f, 0.0f };
+            glm::mat4 view{ glm::lookAt(eye, eye + glm::vec3{ std::cos(angle), -0.2f, std::sin(angle) }, glm::vec3{ 0.0f, 1.0f, 0.0f }) };
+            glm::mat4 view_proj{ glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) * view };
+
+            m_scene.Cull(view_proj);
+            gltk_GLCheck(glUseProgram(m_program));
+            gltk_GLCheck(glUniformMatrix4fv(m_view_proj_location, 1, GL_FALSE, &view_proj[0][0]));
+            m_scene.Draw(m_program);
+            gltk_GLCheck(glDisable(GL_DEPTH_TEST));
+
+            m_frames++;
+            m_visible += m_scene.Stats().visible;
+            m_draw_calls += m_scene.Stats().draw_calls;
+            m_cull_time += m_scene.Stats().cull_time;
+        }
+        void ResetStats() override
+        {
+            m_frames = 0;
+            m_visible = 0;
+            m_draw_calls = 0;
+            m_cull_time = {};
+        }
+        std::string ExtraJson() const override
+        {
+            double frames{ static_cast<double>(std::max<std::int64_t>(m_frames, 1)) };
+            return std::format(", \"indirect\": {}, \"cull_threads\": {}, \"mean_visible\": {:.1f}, \"mean_draw_calls\": {:.1f}, \"mean_cull_ms\": {:.4f}",
+                m_scene.Indirect(), m_pool.ThreadCount() + 1, static_cast<double>(m_visible) / frames, static_cast<double>(m_draw_calls) / frames,
+                std::chrono::duration<double, std::milli>{ m_cull_time }.count() / frames);
+        }
+    private:
+        constexpr static std::uint32_t GRID{ 256 };
+        constexpr static float SPACING{ 3.0f };
+    private:
+        GLuint m_program;
+        GLint m_view_proj_location;
+        GLuint m_vbo;
+        GLuint m_ebo;
+        GLuint m_vao;
+        ThreadPool m_pool;
+        SceneBuffer m_scene;
+        const char* m_name;
+        std::int64_t m_frames;
+        std::int64_t m_visible;
+        std::int64_t m_draw_calls;
+        std::chrono::nanoseconds m_cull_time;
+    };
+
+    // a grid of quads with a different small texture each, either one texture and material per image or all the
+    // images in TextureArrays, where a single material is left and the quads are looked up by their instance
+    class TexturedQuadsScene : public Scene
+    {
+    public:
+        explicit TexturedQuadsScene(bool texture_arrays)
+            : m_program{ BuildProgram(TEXTURED_VERTEX_SHADER_SOURCE, texture_arrays ? TEXTURE_ARRAY_FRAGMENT_SHADER_SOURCE : TEXTURED_FRAGMENT_SHADER_SOURCE) }
+            , m_vbo{}
+            , m_vao{}
+            , m_textures{}
+            , m_arrays{}
+            , m_queue{}
+            , m_materials{}
+            , m_texture_arrays{ texture_arrays }
+            , m_texture_bytes{}
+            , m_frames{}
+            , m_texture_binds{}
+            , m_draw_calls{}
+        {
+            constexpr glm::vec2 VERTICES[]{ { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+            gltk_GLCheck(glGenBuffers(1, &m_vbo));
+            gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+            gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, sizeof(VERTICES), VERTICES, GL_STATIC_DRAW));
+            gltk_GLCheck(glEnableVertexAttribArray(0));
+            gltk_GLCheck(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), nullptr));
+            gltk_GLCheck(glBindVertexArray(0));
+
+            // checkerboards of different sizes and colors
+            std::vector<int> regions{};
+            for (int i{}; i < IMAGES; i++)
+            {
+                int w{ 32 + (i * 7) % 33 };
+                int h{ 32 + (i * 13) % 33 };
+                std::vector<unsigned char> pixels(static_cast<std::size_t>(w) * h * 4);
+                for (int y{}; y < h; y++)
+                {
+                    for (int x{}; x < w; x++)
+                    {
+                        unsigned char* texel{ &pixels[(static_cast<std::size_t>(y) * w + x) * 4] };
+                        bool odd{ ((x / 8) + (y / 8)) % 2 != 0 };
+                        texel[0] = static_cast<unsigned char>(odd ? i * 4 : 255);
+                        texel[1] = static_cast<unsigned char>(odd ? 255 - i * 4 : 128);
+                        texel[2] = static_cast<unsigned char>(odd ? 128 : i * 4);
+                        texel[3] = 255;
+                    }
+                }
+
+                if (texture_arrays)
+                {
+                    regions.push_back(m_arrays.Add(w, h, pixels));
+                }
+                else
+                {
+                    GLuint texture{};
+                    gltk_GLCheck(glGenTextures(1, &texture));
+                    gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, texture));
+                    gltk_GLCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+                    gltk_GLCheck(glGenerateMipmap(GL_TEXTURE_2D));
+                    gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+                    m_textures.push_back(texture);
+                    m_materials.push_back(m_queue.AddMaterial({ .textures = { texture } }));
+                }
+            }
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+            if (texture_arrays)
+            {
+                m_arrays.Build();
+                m_texture_bytes = m_arrays.Stats().bytes;
+                gltk_Check(m_arrays.Textures().size() == 1); // all the images fit one atlas
+                m_materials.push_back(m_queue.AddMaterial({ .textures = { m_arrays.Textures().front() }, .target = GL_TEXTURE_2D_ARRAY }));
+
+                GLint rects_location{};
+                GLint layers_location{};
+                gltk_GLCheck(rects_location = glGetUniformLocation(m_program, "uRects"));
+                gltk_GLCheck(layers_location = glGetUniformLocation(m_program, "uLayers"));
+                gltk_GLCheck(glUseProgram(m_program));
+                for (int i{}; i < IMAGES; i++)
+                {
+                    const TextureRegion& region{ m_arrays.Region(regions[i]) };
+                    float layer{ static_cast<float>(region.layer) };
+                    gltk_GLCheck(glUniform4fv(rects_location + i, 1, &region.rect[0]));
+                    gltk_GLCheck(glUniform1fv(layers_location + i, 1, &layer));
+                }
+                gltk_GLCheck(glUseProgram(0));
+            }
+            else
+            {
+                m_texture_bytes = m_arrays.Stats().separate_bytes;
+                for (GLuint texture : m_textures)
+                {
+                    gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, texture));
+                    for (GLint level{}, w{ 1 }; w > 0; level++)
+                    {
+                        GLint h{};
+                        gltk_GLCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &w));
+                        gltk_GLCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &h));
+                        m_texture_bytes += static_cast<std::int64_t>(w) * h * 4;
+                    }
+                }
+                gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+            }
+        }
+        ~TexturedQuadsScene() noexcept override
+        {
+            gltk_GLCheck(glDeleteTextures(static_cast<GLsizei>(m_textures.size()), m_textures.data()));
+            gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+            gltk_GLCheck(glDeleteBuffers(1, &m_vbo));
+            gltk_GLCheck(glDeleteProgram(m_program));
+        }
+    public:
+        const char* Name() const noexcept override { return m_texture_arrays ? "textured_quads_arrays" : "textured_quads_separate"; }
+        std::int64_t ItemsPerFrame() const noexcept override { return QUADS; }
+        void Render(int /*frame*/) override
+        {
+            gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+            for (std::uint32_t i{}; i < QUADS; i++)
+            {
+                std::uint16_t material{ m_texture_arrays ? m_materials.front() : m_materials[i % IMAGES] };
+                m_queue.Submit({ .program = m_program, .vao = m_vao, .material = material, .count = 6, .instance = i });
+            }
+            m_queue.Flush();
+
+            m_frames++;
+            m_texture_binds += m_queue.Stats().texture_binds;
+            m_draw_calls += m_queue.Stats().draw_calls;
+        }
+        void ResetStats() override
+        {
+            m_frames = 0;
+            m_texture_binds = 0;
+            m_draw_calls = 0;
+        }
+        std::string ExtraJson() const override
+        {
+            double frames{ static_cast<double>(std::max<std::int64_t>(m_frames, 1)) };
+            return std::format(", \"texture_arrays\": {}, \"images\": {}, \"texture_bytes\": {}, \"mean_texture_binds\": {:.1f}, \"mean_draw_calls\": {:.1f}",
+                m_texture_arrays, IMAGES, m_texture_bytes, static_cast<double>(m_texture_binds) / frames, static_cast<double>(m_draw_calls) / frames);
+        }
+    private:
+        constexpr static int IMAGES{ 64 };
+        constexpr static std::uint32_t QUADS{ 1024 };
+    private:
+        GLuint m_program;
+        GLuint m_vbo;
+        GLuint m_vao;
+        std::vector<GLuint> m_textures;
+        TextureArrays m_arrays;
+        RenderQueue m_queue;
+        std::vector<std::uint16_t> m_materials;
+        bool m_texture_arrays;
+        std::int64_t m_texture_bytes;
+        std::int64_t m_frames;
+        std::int64_t m_texture_binds;
+        std::int64_t m_draw_calls;
+    };
+
+    // a dense grid of detailed spheres, most of them behind a wall, drawn one by one either all of them or through
+    // OcclusionCuller while the camera slides sideways
+    class OccludedSpheresScene : public Scene
+    {
+    public:
+        explicit OccludedSpheresScene(bool occlusion)
+            : m_program{ BuildProgram(PLACED_VERTEX_SHADER_SOURCE, FRAGMENT_SHADER_SOURCE) }
+            , m_view_proj_location{}
+            , m_offset_location{}
+            , m_scale_location{}
+            , m_vbo{}
+            , m_ebo{}
+            , m_vao{}
+            , m_index_count{}
+            , m_culler{}
+            , m_occlusion{ occlusion }
+            , m_frames{}
+            , m_drawn{}
+            , m_occluded{}
+            , m_frustum_culled{}
+            , m_queries{}
+            , m_queries_pending{}
+        {
+            gltk_GLCheck(m_view_proj_location = glGetUniformLocation(m_program, "uViewProj"));
+            gltk_GLCheck(m_offset_location = glGetUniformLocation(m_program, "uOffset"));
+            gltk_GLCheck(m_scale_location = glGetUniformLocation(m_program, "uScale"));
+
+            // unit sphere, SEGMENTS * SEGMENTS * 2 triangles
+            std::vector<glm::vec3> vertices{};
+            std::vector<std::uint32_t> indices{};
+            for (std::uint32_t y{}; y <= SEGMENTS; y++)
+            {
+                for (std::uint32_t x{}; x <= SEGMENTS; x++)
+                {
+                    float theta{ glm::pi<float>() * static_cast<float>(y) / SEGMENTS };
+                    float phi{ 2.0f * glm::pi<float>() * static_cast<float>(x) / SEGMENTS };
+                    vertices.push_back({ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+                }
+            }
+            for (std::uint32_t y{}; y < SEGMENTS; y++)
+            {
+                for (std::uint32_t x{}; x < SEGMENTS; x++)
+                {
+                    std::uint32_t a{ y * (SEGMENTS + 1) + x };
+                    std::uint32_t b{ a + SEGMENTS + 1 };
+                    indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+            m_index_count = static_cast<GLsizei>(indices.size());
+
+            gltk_GLCheck(glGenBuffers(1, &m_vbo));
+            gltk_GLCheck(glGenBuffers(1, &m_ebo));
+            gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+            gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW));
+            gltk_GLCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+            gltk_GLCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t), indices.data(), GL_STATIC_DRAW));
+            gltk_GLCheck(glEnableVertexAttribArray(0));
+            gltk_GLCheck(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr));
+            gltk_GLCheck(glBindVertexArray(0));
+
+            for (std::uint32_t i{}; i < GRID * GRID; i++)
+            {
+                glm::vec3 center{ Center(i) };
+                m_culler.Add(center - glm::vec3{ RADIUS }, center + glm::vec3{ RADIUS });
+            }
+        }
+        ~OccludedSpheresScene() noexcept override
+        {
+            gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+            gltk_GLCheck(glDeleteBuffers(1, &m_ebo));
+            gltk_GLCheck(glDeleteBuffers(1, &m_vbo));
+            gltk_GLCheck(glDeleteProgram(m_program));
+        }
+    public:
+        const char* Name() const noexcept override { return m_occlusion ? "occluded_spheres_queries" : "occluded_spheres_all"; }
+        std::int64_t ItemsPerFrame() const noexcept override { return GRID * GRID; }
+        void Render(int frame) override
+        {
+            gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
+            gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+            gltk_GLCheck(glEnable(GL_DEPTH_TEST));
+
+            glm::vec3 eye{ 4.0f * std::sin(static_cast<float>(frame) * 0.02f), 2.0f, 8.0f };
+            glm::mat4 view{ glm::lookAt(eye, glm::vec3{ 0.0f, 0.0f, -20.0f }, glm::vec3{ 0.0f, 1.0f, 0.0f }) };
+            glm::mat4 view_proj{ glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f) * view };
+
+            // the wall, a flattened sphere
+            gltk_GLCheck(glUseProgram(m_program));
+            gltk_GLCheck(glUniformMatrix4fv(m_view_proj_location, 1, GL_FALSE, &view_proj[0][0]));
+            gltk_GLCheck(glBindVertexArray(m_vao));
+            gltk_GLCheck(glUniform3f(m_offset_location, 0.0f, 0.0f, 0.0f));
+            gltk_GLCheck(glUniform3f(m_scale_location, 6.0f, 3.0f, 0.2f));
+            gltk_GLCheck(glDrawElements(GL_TRIANGLES, m_index_count, GL_UNSIGNED_INT, nullptr));
+
+            auto draw{ [this](std::uint32_t sphere)
+            {
+                glm::vec3 center{ Center(sphere) };
+                gltk_GLCheck(glUseProgram(m_program));
+                gltk_GLCheck(glBindVertexArray(m_vao));
+                gltk_GLCheck(glUniform3f(m_offset_location, center.x, center.y, center.z));
+                gltk_GLCheck(glUniform3f(m_scale_location, RADIUS, RADIUS, RADIUS));
+                gltk_GLCheck(glDrawElements(GL_TRIANGLES, m_index_count, GL_UNSIGNED_INT, nullptr));
+            } };
+            if (m_occlusion)
+            {
+                m_culler.Render(view_proj, draw);
+                const OcclusionStats& stats{ m_culler.Stats() };
+                m_drawn += stats.drawn;
+                m_occluded += stats.occluded;
+                m_frustum_culled += stats.frustum_culled;
+                m_queries += stats.queries;
+                m_queries_pending += stats.queries_pending;
+            }
+            else
+            {
+                for (std::uint32_t i{}; i < GRID * GRID; i++)
+                {
+                    draw(i);
+                }
+                m_drawn += GRID * GRID;
+            }
+            gltk_GLCheck(glDisable(GL_DEPTH_TEST));
+            m_frames++;
+        }
+        void ResetStats() override
+        {
+            m_frames = 0;
+            m_drawn = 0;
+            m_occluded = 0;
+            m_frustum_culled = 0;
+            m_queries = 0;
+            m_queries_pending = 0;
+        }
+        std::string ExtraJson() const override
+        {
+            double frames{ static_cast<double>(std::max<std::int64_t>(m_frames, 1)) };
+            return std::format(", \"occlusion\": {}, \"mean_drawn\": {:.1f}, \"mean_occluded\": {:.1f}, \"mean_frustum_culled\": {:.1f}, "
+                "\"mean_queries\": {:.1f}, \"mean_queries_pending\": {:.1f}",
+                m_occlusion, static_cast<double>(m_drawn) / frames, static_cast<double>(m_occluded) / frames, static_cast<double>(m_frustum_culled) / frames,
+                static_cast<double>(m_queries) / frames, static_cast<double>(m_queries_pending) / frames);
+        }
+    private:
+        static glm::vec3 Center(std::uint32_t sphere)
+        {
+            return { (static_cast<float>(sphere % GRID) - GRID / 2.0f) * SPACING, 0.0f, -2.0f - static_cast<float>(sphere / GRID) * SPACING };
+        }
+    private:
+        constexpr static std::uint32_t GRID{ 32 };
+        constexpr static std::uint32_t SEGMENTS{ 32 };
+        constexpr static float SPACING{ 1.5f };
+        constexpr static float RADIUS{ 0.5f };
+    private:
+        GLuint m_program;
+        GLint m_view_proj_location;
+        GLint m_offset_location;
+        GLint m_scale_location;
+        GLuint m_vbo;
+        GLuint m_ebo;
+        GLuint m_vao;
+        GLsizei m_index_count;
+        OcclusionCuller m_culler;
+        bool m_occlusion;
+        std::int64_t m_frames;
+        std::int64_t m_drawn;
+        std::int64_t m_occluded;
+        std::int64_t m_frustum_culled;
+        std::int64_t m_queries;
+        std::int64_t m_queries_pending;
+    };
+
+    struct SceneResult
+    {
+        std::string name;
+        int frames;
+        double min_ms;
+        double median_ms;
+        double p99_ms;
+        double mean_ms;
+        double fps;
+        double items_per_second;
+        std::string extra; // Scene::ExtraJson
+    };
+
+    static SceneResult RunScene(Scene& scene, RenderTarget& target, int warmup_frames, int frames)
+    {
+        std::vector<double> frame_ms{};
+        frame_ms.reserve(frames);
+        for (int frame{}; frame < warmup_frames + frames; frame++)
+        {
+            if (frame == warmup_frames)
+            {
+                scene.ResetStats();
+            }
+            auto start{ std::chrono::steady_clock::now() };
+            target.Bind();
+            scene.Render(frame);
+            gltk_GLCheckpoint();
+            gltk_GLCheck(glFinish());
+            std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+            if (frame >= warmup_frames)
+            {
+                frame_ms.push_back(elapsed.count());
+            }
+        }
+
+        SceneResult result{};
+        result.name = scene.Name();
+        result.frames = frames;
+        double total_ms{};
+        for (double ms : frame_ms)
+        {
+            total_ms += ms;
+        }
+        std::sort(frame_ms.begin(), frame_ms.end());
+        auto percentile{ [&](double p) { return frame_ms[static_cast<std::size_t>(std::ceil(p * frame_ms.size())) - 1]; } };
+        result.min_ms = frame_ms.front();
+        result.median_ms = percentile(0.5);
+        result.p99_ms = percentile(0.99);
+        result.mean_ms = total_ms / frames;
+        result.fps = 1000.0 * frames / total_ms;
+        result.items_per_second = result.fps * static_cast<double>(scene.ItemsPerFrame());
+        result.extra = scene.ExtraJson();
+        return result;
+    }
+
+    static std::string EscapeJson(std::string_view str)
+    {
+        std::string escaped{};
+        for (char c : str)
+        {
+            switch (c)
+            {
+            case '"': { escaped += "\\\""; } break;
+            case '\\': { escaped += "\\\\"; } break;
+            default: { escaped += c; } break;
+            }
+        }
+        return escaped;
+    }
+
+    static bool ParseInt(const char* str, int& value, int min_value = 1)
+    {
+        std::string_view sv{ str };
+        auto [end, ec] { std::from_chars(sv.data(), sv.data() + sv.size(), value) };
+        return ec == std::errc{} && end == sv.data() + sv.size() && value >= min_value;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace gltk::bench;
+
+    int frames{ 300 };
+    int warmup_frames{ 30 };
+    int width{ 1280 };
+    int height{ 720 };
+    std::string only_scene{};
+    std::string output_path{};
+    for (int i{ 1 }; i < argc; i++)
+    {
+        std::string_view arg{ argv[i] };
+        bool has_value{ i + 1 < argc };
+        bool ok{ has_value };
+        if (arg == "--frames" && has_value) { ok = ParseInt(argv[++i], frames); }
+        else if (arg == "--warmup" && has_value) { ok = ParseInt(argv[++i], warmup_frames, 0); }
+        else if (arg == "--width" && has_value) { ok = ParseInt(argv[++i], width); }
+        else if (arg == "--height" && has_value) { ok = ParseInt(argv[++i], height); }
+        else if (arg == "--scene" && has_value) { only_scene = argv[++i]; }
+        else if (arg == "--output" && has_value) { output_path = argv[++i]; }
+        else { ok = false; }
+
+        if (!ok)
+        {
+            std::cerr << "usage: gltk_frame_bench [--frames N] [--warmup N] [--width W] [--height H] [--scene NAME] [--output FILE]\n";
+            return 1;
+        }
+    }
+
+    try
+    {
+        HeadlessContext context{ width, height };
+        if (!context.Valid())
+        {
+            std::cerr << "[BENCH]: failed to create a headless OpenGL context\n";
+            return 1;
+        }
+
+        std::vector<SceneResult> results{};
+        {
+            gltk::RenderTarget target{ width, height };
+            std::vector<std::unique_ptr<Scene>> scenes{};
+            scenes.push_back(std::make_unique<ClearScene>());
+            scenes.push_back(std::make_unique<StreamTrianglesScene>());
+            scenes.push_back(std::make_unique<InstancedTrianglesScene>());
+            scenes.push_back(std::make_unique<CulledInstancesScene>(true));
+            scenes.push_back(std::make_unique<CulledInstancesScene>(false));
+            scenes.push_back(std::make_unique<TexturedQuadsScene>(false));
+            scenes.push_back(std::make_unique<TexturedQuadsScene>(true));
+            scenes.push_back(std::make_unique<OccludedSpheresScene>(false));
+            scenes.push_back(std::make_unique<OccludedSpheresScene>(true));
+            for (const std::unique_ptr<Scene>& scene : scenes)
+            {
+                if (only_scene.empty() || only_scene == scene->Name())
+                {
+                    results.push_back(RunScene(*scene, target, warmup_frames, frames));
+                }
+            }
+        }
+        if (results.empty())
+        {
+            std::cerr << std::format("[BENCH]: unknown scene '{}'\n", only_scene);
+            return 1;
+        }
+
+        std::string json{};
+        json += std::format("{{\n  \"renderer\": \"{}\",\n  \"platform\": \"{}\",\n  \"width\": {},\n  \"height\": {},\n  \"scenes\": [\n",
+            EscapeJson(context.Renderer()), context.Platform(), width, height);
+        for (std::size_t i{}; i < results.size(); i++)
+        {
+            const SceneResult& r{ results[i] };
+            json += std::format("    {{ \"name\": \"{}\", \"frames\": {}, \"min_ms\": {:.4f}, \"median_ms\": {:.4f}, \"p99_ms\": {:.4f}, "
+                "\"mean_ms\": {:.4f}, \"fps\": {:.2f}, \"items_per_second\": {:.0f}{} }}{}\n",
+                r.name, r.frames, r.min_ms, r.median_ms, r.p99_ms, r.mean_ms, r.fps, r.items_per_second, r.extra, i + 1 < results.size() ? "," : "");
+        }
+        json += "  ]\n}\n";
+
+        if (output_path.empty())
+        {
+            std::cout << json;
+        }
+        else
+        {
+            std::ofstream file{ output_path };
+            file << json;
+            if (!file)
+            {
+                std::cerr << std::format("[BENCH]: failed to write '{}'\n", output_path);
+                return 1;
+            }
+        }
+    }
+    catch (const gltk::Crash& e)
+    {
+        std::cerr << e.What() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
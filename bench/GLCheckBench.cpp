@@ -0,0 +1,58 @@
+#include <Bench.h>
+#include <Headless.h>
+
+#include <glad/glad.h>
+
+#include <gltk/GLCheck.h>
+
+#include <format>
+#include <iostream>
+
+namespace gltk::bench
+{
+    static GLenum APIENTRY StubGetError()
+    {
+        return GL_NO_ERROR;
+    }
+    static void APIENTRY StubBindBuffer(GLenum, GLuint)
+    {
+    }
+
+    // measures the cost of each gltk_GLCheck policy around a cheap GL call, with a real context when one can be
+    // created (headless) and with stubbed entry points otherwise, which only measures the CPU side
+    void RunGLCheckBenchmarks(std::vector<Result>& results)
+    {
+        constexpr std::int64_t ITERATIONS{ 1'000'000 };
+        constexpr int CALLS_PER_CHECKPOINT{ 1000 }; // roughly the GL calls of a frame
+
+        HeadlessContext context{ 64, 64 };
+        if (!context.Valid())
+        {
+            std::cerr << "[BENCH]: no OpenGL context, GL check benchmarks use stubbed entry points\n";
+            glad_glGetError = StubGetError;
+            glad_glBindBuffer = StubBindBuffer;
+        }
+        std::string suffix{ context.Valid() ? "" : " (stub)" };
+
+        results.push_back(Measure("gl_check/none" + suffix, ITERATIONS, []()
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }));
+        results.push_back(Measure("gl_check/per_call" + suffix, ITERATIONS, []()
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            PrintGLErrorsIfAny(__FILE__, __LINE__);
+        }));
+        int calls{};
+        results.push_back(Measure("gl_check/deferred" + suffix, ITERATIONS, [&calls]()
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            RecordGLCall(__FILE__, __LINE__);
+            if (++calls == CALLS_PER_CHECKPOINT)
+            {
+                CheckGLCalls(__FILE__, __LINE__);
+                calls = 0;
+            }
+        }));
+    }
+}
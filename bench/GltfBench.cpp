@@ -0,0 +1,182 @@
+#include <Bench.h>
+
+#include <gltk/Check.h>
+
+#include <tiny_gltf.h>
+
+#include <algorithm>
+#include <format>
+#include <sstream>
+
+namespace gltk::bench
+{
+    // A scene shaped like a large exported level: many meshes with their own accessors and materials, and a node
+    // hierarchy much larger than the mesh count, over one buffer. Vertex data is filler, only its size matters.
+    static tinygltf::Model GenerateModel()
+    {
+        constexpr int MESHES{ 500 };
+        constexpr int VERTICES{ 1000 };
+        constexpr int INDICES{ 3000 };
+        constexpr int MATERIALS{ 100 };
+        constexpr int NODES{ 20000 };
+
+        tinygltf::Model model{};
+        model.asset.version = "2.0";
+        model.asset.generator = "gltk_bench";
+
+        // positions, normals, texture coordinates and indices, one view each
+        constexpr std::size_t VIEW_STRIDES[]{ 12, 12, 8 };
+        std::size_t view_sizes[]{ MESHES * VERTICES * VIEW_STRIDES[0], MESHES * VERTICES * VIEW_STRIDES[1], MESHES * VERTICES * VIEW_STRIDES[2],
+            MESHES * INDICES * sizeof(std::uint32_t) };
+        tinygltf::Buffer buffer{};
+        std::size_t offset{};
+        for (int i{}; i < 4; i++)
+        {
+            tinygltf::BufferView view{};
+            view.buffer = 0;
+            view.byteOffset = offset;
+            view.byteLength = view_sizes[i];
+            view.target = i == 3 ? TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER : TINYGLTF_TARGET_ARRAY_BUFFER;
+            model.bufferViews.push_back(view);
+            offset += view_sizes[i];
+        }
+        buffer.data.resize(offset);
+        for (std::size_t i{}; i < buffer.data.size(); i++)
+        {
+            buffer.data[i] = static_cast<unsigned char>(i * 2654435761u >> 24);
+        }
+        model.buffers.push_back(buffer);
+
+        for (int i{}; i < MATERIALS; i++)
+        {
+            tinygltf::Material material{};
+            material.name = std::format("material_{}", i);
+            material.pbrMetallicRoughness.baseColorFactor = { 0.8, 0.8, 0.8, 1.0 };
+            material.pbrMetallicRoughness.roughnessFactor = 0.5;
+            model.materials.push_back(material);
+        }
+
+        for (int i{}; i < MESHES; i++)
+        {
+            tinygltf::Primitive primitive{};
+            constexpr const char* ATTRIBUTES[]{ "POSITION", "NORMAL", "TEXCOORD_0" };
+            constexpr int TYPES[]{ TINYGLTF_TYPE_VEC3, TINYGLTF_TYPE_VEC3, TINYGLTF_TYPE_VEC2 };
+            for (int attribute{}; attribute < 3; attribute++)
+            {
+                tinygltf::Accessor accessor{};
+                accessor.bufferView = attribute;
+                accessor.byteOffset = static_cast<std::size_t>(i) * VERTICES * VIEW_STRIDES[attribute];
+                accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+                accessor.count = VERTICES;
+                accessor.type = TYPES[attribute];
+                if (attribute == 0)
+                {
+                    accessor.minValues = { -1.0, -1.0, -1.0 };
+                    accessor.maxValues = { 1.0, 1.0, 1.0 };
+                }
+                primitive.attributes[ATTRIBUTES[attribute]] = static_cast<int>(model.accessors.size());
+                model.accessors.push_back(accessor);
+            }
+
+            tinygltf::Accessor indices{};
+            indices.bufferView = 3;
+            indices.byteOffset = static_cast<std::size_t>(i) * INDICES * sizeof(std::uint32_t);
+            indices.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+            indices.count = INDICES;
+            indices.type = TINYGLTF_TYPE_SCALAR;
+            primitive.indices = static_cast<int>(model.accessors.size());
+            model.accessors.push_back(indices);
+            primitive.material = i % MATERIALS;
+            primitive.mode = TINYGLTF_MODE_TRIANGLES;
+
+            tinygltf::Mesh mesh{};
+            mesh.name = std::format("mesh_{}", i);
+            mesh.primitives.push_back(primitive);
+            model.meshes.push_back(mesh);
+        }
+
+        // a root holding groups of 100 nodes each
+        tinygltf::Scene scene{};
+        for (int i{}; i < NODES; i++)
+        {
+            tinygltf::Node node{};
+            node.name = std::format("node_{}", i);
+            if (i % 100 == 0)
+            {
+                scene.nodes.push_back(i);
+                for (int child{ i + 1 }; child < std::min(i + 100, NODES); child++)
+                {
+                    node.children.push_back(child);
+                }
+            }
+            else
+            {
+                node.mesh = i % MESHES;
+                node.translation = { static_cast<double>(i % 97), 0.0, static_cast<double>(i / 97) };
+                node.rotation = { 0.0, 0.3826834, 0.0, 0.9238795 };
+                node.scale = { 1.0, 1.0, 1.0 };
+            }
+            model.nodes.push_back(node);
+        }
+        model.scenes.push_back(scene);
+        model.defaultScene = 0;
+        return model;
+    }
+
+    // measures tinygltf parsing (JSON and buffers, images kept encoded as GltfLoader does) of a generated scene,
+    // as .glb and as .gltf with its buffer embedded in base64, and of the given files
+    void RunGltfBenchmarks(std::vector<Result>& results, const std::vector<std::filesystem::path>& files)
+    {
+        constexpr std::int64_t ITERATIONS{ 2 };
+
+        tinygltf::TinyGLTF writer{};
+        tinygltf::Model generated{ GenerateModel() };
+        std::ostringstream glb_stream{};
+        std::ostringstream gltf_stream{};
+        gltk_Check(writer.WriteGltfSceneToStream(&generated, glb_stream, false, true));
+        gltk_Check(writer.WriteGltfSceneToStream(&generated, gltf_stream, false, false));
+        std::string glb{ glb_stream.str() };
+        std::string gltf{ gltf_stream.str() };
+
+        auto parse{ [](auto&& load)
+        {
+            tinygltf::TinyGLTF loader{};
+            loader.SetImagesAsIs(true);
+            tinygltf::Model model{};
+            std::string err{};
+            std::string warn{};
+            gltk_Check(load(loader, model, err, warn));
+            DoNotOptimize(model.nodes.size());
+        } };
+
+        results.push_back(Measure("gltf/parse_glb", ITERATIONS, [&]()
+        {
+            parse([&glb](tinygltf::TinyGLTF& loader, tinygltf::Model& model, std::string& err, std::string& warn)
+            {
+                return loader.LoadBinaryFromMemory(&model, &err, &warn, reinterpret_cast<const unsigned char*>(glb.data()), static_cast<unsigned int>(glb.size()));
+            });
+        }, static_cast<std::int64_t>(glb.size())));
+        results.push_back(Measure("gltf/parse_gltf_embedded", ITERATIONS, [&]()
+        {
+            parse([&gltf](tinygltf::TinyGLTF& loader, tinygltf::Model& model, std::string& err, std::string& warn)
+            {
+                return loader.LoadASCIIFromString(&model, &err, &warn, gltf.data(), static_cast<unsigned int>(gltf.size()), "");
+            });
+        }, static_cast<std::int64_t>(gltf.size())));
+
+        for (const std::filesystem::path& file : files)
+        {
+            std::error_code ec{};
+            std::uintmax_t size{ std::filesystem::file_size(file, ec) };
+            gltk_Check(!ec);
+            bool binary{ file.extension() == ".glb" };
+            results.push_back(Measure(FileBenchmarkName("gltf/parse_file/", file), ITERATIONS, [&]()
+            {
+                parse([&](tinygltf::TinyGLTF& loader, tinygltf::Model& model, std::string& err, std::string& warn)
+                {
+                    return binary ? loader.LoadBinaryFromFile(&model, &err, &warn, file.string()) : loader.LoadASCIIFromFile(&model, &err, &warn, file.string());
+                });
+            }, static_cast<std::int64_t>(size)));
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include <Headless.h>
+
+#include <glad/glad.h> // NOTE: before glfw
+#include <GLFW/glfw3.h>
+
+namespace gltk::bench
+{
+    HeadlessContext::HeadlessContext(int width, int height)
+        : m_window{}
+        , m_platform{}
+        , m_renderer{}
+    {
+        if (glfwInit() && TryCreate(width, height))
+        {
+            m_platform = "default";
+        }
+        else
+        {
+            glfwTerminate();
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            if (glfwInit())
+            {
+                glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+                if (TryCreate(width, height))
+                {
+                    m_platform = "null/osmesa";
+                }
+            }
+            glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+        }
+
+        if (m_window)
+        {
+            const GLubyte* renderer{ glGetString(GL_RENDERER) };
+            m_renderer = renderer ? reinterpret_cast<const char*>(renderer) : "";
+        }
+    }
+    HeadlessContext::~HeadlessContext()
+    {
+        if (m_window)
+        {
+            glfwDestroyWindow(m_window);
+        }
+        glfwTerminate();
+    }
+    bool HeadlessContext::TryCreate(int width, int height)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        #ifdef __APPLE__
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        #endif
+
+        GLFWwindow* window{ glfwCreateWindow(width, height, "gltk_bench", nullptr, nullptr) };
+        if (!window)
+        {
+            return false;
+        }
+
+        glfwMakeContextCurrent(window);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            glfwDestroyWindow(window);
+            return false;
+        }
+
+        glfwSwapInterval(0);
+        m_window = window;
+        return true;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+
+struct GLFWwindow;
+
+namespace gltk::bench
+{
+    // OpenGL 3.3 core context without anything on screen. A hidden window on the default GLFW platform is tried
+    // first; when that fails (no display, e.g. CI or a render farm node) GLFW's null platform is used with an
+    // OSMesa context, which Mesa backs with llvmpipe. Vsync is off. Valid() is false if neither worked.
+    class HeadlessContext
+    {
+    public:
+        HeadlessContext(int width, int height);
+        ~HeadlessContext() noexcept;
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext(HeadlessContext&&) noexcept = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(HeadlessContext&&) noexcept = delete;
+    public:
+        bool Valid() const noexcept { return m_window != nullptr; }
+        GLFWwindow* Window() const noexcept { return m_window; }
+        const std::string& Platform() const noexcept { return m_platform; } // "default" or "null/osmesa"
+        const std::string& Renderer() const noexcept { return m_renderer; }
+    private:
+        bool TryCreate(int width, int height);
+    private:
+        GLFWwindow* m_window;
+        std::string m_platform;
+        std::string m_renderer;
+    };
+}
@@ -0,0 +1,96 @@
+#include <Bench.h>
+
+#include <gltk/Check.h>
+#include <gltk/MappedFile.h>
+
+#include <stb_image.h>
+#include <tiny_gltf.h>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace gltk::bench
+{
+    // smooth gradients with a little noise, so that it compresses like a photo or a painted texture rather than
+    // like flat color or like noise
+    static tinygltf::Image GenerateImage()
+    {
+        constexpr int SIZE{ 1024 };
+
+        tinygltf::Image image{};
+        image.width = SIZE;
+        image.height = SIZE;
+        image.component = 4;
+        image.bits = 8;
+        image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+        image.image.resize(static_cast<std::size_t>(SIZE) * SIZE * 4);
+        std::uint32_t state{ 12345 };
+        for (int y{}; y < SIZE; y++)
+        {
+            for (int x{}; x < SIZE; x++)
+            {
+                state = state * 1664525u + 1013904223u;
+                int noise{ static_cast<int>(state >> 29) - 4 };
+                float u{ static_cast<float>(x) / SIZE };
+                float v{ static_cast<float>(y) / SIZE };
+                unsigned char* texel{ &image.image[(static_cast<std::size_t>(y) * SIZE + x) * 4] };
+                texel[0] = static_cast<unsigned char>(std::clamp(static_cast<int>(128.0f + 100.0f * std::sin(6.0f * u + 2.0f * v)) + noise, 0, 255));
+                texel[1] = static_cast<unsigned char>(std::clamp(static_cast<int>(128.0f + 100.0f * std::cos(4.0f * v - 3.0f * u)) + noise, 0, 255));
+                texel[2] = static_cast<unsigned char>(std::clamp(static_cast<int>(255.0f * u * v) + noise, 0, 255));
+                texel[3] = 255;
+            }
+        }
+        return image;
+    }
+
+    // encodes through tinygltf's image writer, the stb_image_write build that already ships in the link
+    static std::vector<unsigned char> Encode(const tinygltf::Image& image, const std::string& filename)
+    {
+        std::vector<unsigned char> encoded{};
+        tinygltf::FsCallbacks fs{};
+        fs.WriteWholeFile = [&encoded](std::string*, const std::string&, const std::vector<unsigned char>& contents, void*)
+        {
+            encoded = contents;
+            return true;
+        };
+        tinygltf::URICallbacks uri{};
+        std::string basepath{};
+        std::string out_uri{};
+        gltk_Check(tinygltf::WriteImageData(&basepath, &filename, &image, false, &fs, &uri, &out_uri, nullptr));
+        return encoded;
+    }
+
+    // measures stb_image decoding to RGBA8, as the texture and glTF loaders do, of generated PNG and JPEG images and
+    // of the given files
+    void RunImageBenchmarks(std::vector<Result>& results, const std::vector<std::filesystem::path>& files)
+    {
+        constexpr std::int64_t ITERATIONS{ 5 };
+
+        auto decode{ [](std::span<const unsigned char> encoded)
+        {
+            int w{};
+            int h{};
+            int comp{};
+            stbi_uc* pixels{ stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &w, &h, &comp, 4) };
+            gltk_Check(pixels);
+            DoNotOptimize(pixels[0]);
+            stbi_image_free(pixels);
+        } };
+
+        tinygltf::Image image{ GenerateImage() };
+        std::vector<unsigned char> png{ Encode(image, "bench.png") };
+        std::vector<unsigned char> jpg{ Encode(image, "bench.jpg") };
+        results.push_back(Measure("stb/decode_png", ITERATIONS, [&]() { decode(png); }, static_cast<std::int64_t>(png.size())));
+        results.push_back(Measure("stb/decode_jpg", ITERATIONS, [&]() { decode(jpg); }, static_cast<std::int64_t>(jpg.size())));
+
+        for (const std::filesystem::path& file : files)
+        {
+            MappedFile mapped{ file };
+            gltk_Check(mapped.Valid());
+            std::span<const unsigned char> encoded{ reinterpret_cast<const unsigned char*>(mapped.Data().data()), mapped.Size() };
+            results.push_back(Measure(FileBenchmarkName("stb/decode_file/", file), ITERATIONS, [&]() { decode(encoded); },
+                static_cast<std::int64_t>(encoded.size())));
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include <Bench.h>
+
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Runs the CPU-side benchmarks and prints them as a table. With --output the results are also written as JSON,
+// one benchmark per line in a fixed key order, so that files diff cleanly and can be read back as a --baseline:
+// each benchmark is then compared to the baseline one of the same name, and any that got slower by more than
+// --threshold percent fails the run.
+
+namespace gltk::bench
+{
+    static bool ParseDouble(std::string_view text, double& value)
+    {
+        auto [end, ec] { std::from_chars(text.data(), text.data() + text.size(), value) };
+        return ec == std::errc{} && end == text.data() + text.size();
+    }
+
+    // reads back what WriteJson wrote, line by line; times must be positive, they divide the new ones
+    static bool ReadBaseline(const std::string& path, std::map<std::string, double>& ns_per_op)
+    {
+        std::ifstream file{ path };
+        if (!file)
+        {
+            return false;
+        }
+        for (std::string line{}; std::getline(file, line);)
+        {
+            constexpr std::string_view NAME_KEY{ "\"name\": \"" };
+            constexpr std::string_view NS_KEY{ "\"ns_per_op\": " };
+            std::size_t name{ line.find(NAME_KEY) };
+            std::size_t ns{ line.find(NS_KEY) };
+            if (name == std::string::npos || ns == std::string::npos)
+            {
+                continue;
+            }
+            name += NAME_KEY.size();
+            ns += NS_KEY.size();
+            std::size_t name_end{ line.find('"', name) };
+            std::size_t ns_end{ line.find_first_of(",}", ns) };
+            double value{};
+            if (name_end == std::string::npos || ns_end == std::string::npos || !ParseDouble(std::string_view{ line }.substr(ns, ns_end - ns), value)
+                || !(value > 0.0))
+            {
+                return false;
+            }
+            ns_per_op[line.substr(name, name_end - name)] = value;
+        }
+        return true;
+    }
+
+    static std::string WriteJson(const std::vector<Result>& results)
+    {
+        std::string json{ "{\n  \"benchmarks\": [\n" };
+        for (std::size_t i{}; i < results.size(); i++)
+        {
+            const Result& r{ results[i] };
+            double mib_per_second{ r.bytes_per_op > 0 ? static_cast<double>(r.bytes_per_op) / r.ns_per_op * 1e9 / (1024.0 * 1024.0) : 0.0 };
+            json += std::format("    {{ \"name\": \"{}\", \"iterations\": {}, \"repetitions\": {}, \"ns_per_op\": {:.3f}, \"bytes_per_op\": {}, \"mib_per_second\": {:.2f} }}{}\n",
+                r.name, r.iterations, REPETITIONS, r.ns_per_op, r.bytes_per_op, mib_per_second, i + 1 < results.size() ? "," : "");
+        }
+        json += "  ]\n}\n";
+        return json;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace gltk::bench;
+
+    std::string filter{};
+    std::string output_path{};
+    std::string baseline_path{};
+    double threshold_percent{ 10.0 };
+    std::vector<std::filesystem::path> gltf_files{};
+    std::vector<std::filesystem::path> image_files{};
+    for (int i{ 1 }; i < argc; i++)
+    {
+        std::string_view arg{ argv[i] };
+        bool has_value{ i + 1 < argc };
+        bool ok{ true };
+        if (arg == "--filter" && has_value) { filter = argv[++i]; }
+        else if (arg == "--output" && has_value) { output_path = argv[++i]; }
+        else if (arg == "--baseline" && has_value) { baseline_path = argv[++i]; }
+        else if (arg == "--threshold" && has_value) { ok = ParseDouble(argv[++i], threshold_percent) && threshold_percent >= 0.0; }
+        else if (arg == "--gltf" && has_value) { gltf_files.emplace_back(argv[++i]); ok = std::filesystem::is_regular_file(gltf_files.back()); }
+        else if (arg == "--image" && has_value) { image_files.emplace_back(argv[++i]); ok = std::filesystem::is_regular_file(image_files.back()); }
+        else { ok = false; }
+
+        if (!ok)
+        {
+            std::cerr << "usage: gltk_bench [--filter PREFIX] [--output FILE] [--baseline FILE] [--threshold PERCENT] [--gltf FILE]... [--image FILE]...\n";
+            return 1;
+        }
+    }
+
+    std::map<std::string, double> baseline{};
+    if (!baseline_path.empty() && !ReadBaseline(baseline_path, baseline))
+    {
+        std::cerr << std::format("[BENCH]: could not read baseline '{}'\n", baseline_path);
+        return 1;
+    }
+
+    // the filter is a name prefix, suites are skipped as a whole when none of their names can match it
+    auto wanted{ [&filter](std::string_view prefix) { return filter.starts_with(prefix) || prefix.starts_with(filter); } };
+    std::vector<Result> results{};
+    if (wanted("check/") || wanted("verify/") || wanted("crash/")) { RunCheckBenchmarks(results); }
+    if (wanted("gl_check/")) { RunGLCheckBenchmarks(results); }
+    if (wanted("gltf/")) { RunGltfBenchmarks(results, gltf_files); }
+    if (wanted("stb/")) { RunImageBenchmarks(results, image_files); }
+    if (wanted("std140/")) { RunStd140Benchmarks(results); }
+    std::erase_if(results, [&filter](const Result& result) { return !result.name.starts_with(filter); });
+
+    int regressions{};
+    for (const Result& result : results)
+    {
+        std::string line{ std::format("{:<40} {:>14.2f} ns/op", result.name, result.ns_per_op) };
+        if (result.bytes_per_op > 0)
+        {
+            line += std::format(" {:>10.1f} MiB/s", static_cast<double>(result.bytes_per_op) / result.ns_per_op * 1e9 / (1024.0 * 1024.0));
+        }
+        if (auto it{ baseline.find(result.name) }; it != baseline.end())
+        {
+            double change_percent{ (result.ns_per_op / it->second - 1.0) * 100.0 };
+            bool regressed{ change_percent > threshold_percent };
+            regressions += regressed;
+            line += std::format("  {:+7.1f}% vs baseline{}", change_percent, regressed ? "  REGRESSION" : "");
+        }
+        else if (!baseline_path.empty())
+        {
+            line += "  (not in baseline)";
+        }
+        std::cout << line << '\n';
+    }
+
+    if (!output_path.empty())
+    {
+        std::ofstream file{ output_path };
+        file << WriteJson(results);
+        if (!file)
+        {
+            std::cerr << std::format("[BENCH]: could not write '{}'\n", output_path);
+            return 1;
+        }
+    }
+    if (regressions > 0)
+    {
+        std::cerr << std::format("[BENCH]: {} benchmark(s) slower than the baseline by more than {}%\n", regressions, threshold_percent);
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include <Bench.h>
+
+#include <glad/glad.h>
+
+#include <gltk/Std140.h>
+#include <gltk/UniformBuffer.h>
+
+#include <cstring>
+
+namespace gltk::bench
+{
+    // a typical per-view block: matrices, a mat3 that std140 pads to three vec4, a vec3 packed with a scalar and a
+    // padded array
+    struct alignas(16) ViewBlock
+    {
+        glm::mat4 view;
+        glm::mat4 proj;
+        Std140Mat3 normal;
+        alignas(16) glm::vec3 eye;
+        float time;
+        Std140Array<glm::vec4, 16> lights;
+        std::int32_t light_count;
+    };
+    using ViewBlockLayout = Std140Layout<glm::mat4, glm::mat4, Std140Mat3, glm::vec3, float, Std140Array<glm::vec4, 16>, std::int32_t>;
+    gltk_Std140Member(ViewBlock, view, ViewBlockLayout, 0);
+    gltk_Std140Member(ViewBlock, proj, ViewBlockLayout, 1);
+    gltk_Std140Member(ViewBlock, normal, ViewBlockLayout, 2);
+    gltk_Std140Member(ViewBlock, eye, ViewBlockLayout, 3);
+    gltk_Std140Member(ViewBlock, time, ViewBlockLayout, 4);
+    gltk_Std140Member(ViewBlock, lights, ViewBlockLayout, 5);
+    gltk_Std140Member(ViewBlock, light_count, ViewBlockLayout, 6);
+    gltk_Std140Block(ViewBlock, ViewBlockLayout);
+
+    static void APIENTRY StubGenBuffers(GLsizei n, GLuint* buffers)
+    {
+        for (GLsizei i{}; i < n; i++)
+        {
+            buffers[i] = static_cast<GLuint>(i + 1);
+        }
+    }
+    static void APIENTRY StubDeleteBuffers(GLsizei, const GLuint*)
+    {
+    }
+    static void APIENTRY StubBindBuffer(GLenum, GLuint)
+    {
+    }
+    static void APIENTRY StubBufferData(GLenum, GLsizeiptr, const void*, GLenum)
+    {
+    }
+    static void APIENTRY StubBufferSubData(GLenum, GLintptr, GLsizeiptr, const void*)
+    {
+    }
+    static GLenum APIENTRY StubGetError()
+    {
+        return GL_NO_ERROR;
+    }
+
+    // measures filling a std140 block from glm values, and UniformBlock's member writes with dirty range tracking
+    // and merging; GL entry points are stubbed for the latter, so only gltk's side is measured and no context is needed
+    void RunStd140Benchmarks(std::vector<Result>& results)
+    {
+        constexpr std::int64_t ITERATIONS{ 1'000'000 };
+
+        glm::mat4 view{ 1.0f };
+        glm::mat4 proj{ 2.0f };
+        float time{};
+        alignas(16) unsigned char shadow[sizeof(ViewBlock)]{};
+        results.push_back(Measure("std140/pack_block", ITERATIONS, [&]()
+        {
+            ViewBlock block{};
+            block.view = view;
+            block.proj = proj;
+            block.normal = glm::transpose(glm::inverse(glm::mat3{ view }));
+            block.eye = glm::vec3{ view[3] };
+            block.time = (time += 0.01f);
+            for (int i{}; i < 16; i++)
+            {
+                block.lights[i] = glm::vec4{ static_cast<float>(i), time, 0.0f, 1.0f };
+            }
+            block.light_count = 16;
+            std::memcpy(shadow, &block, sizeof(block));
+            DoNotOptimize(shadow[0]);
+        }, static_cast<std::int64_t>(sizeof(ViewBlock))));
+
+        auto gen_buffers{ glad_glGenBuffers };
+        auto delete_buffers{ glad_glDeleteBuffers };
+        auto bind_buffer{ glad_glBindBuffer };
+        auto buffer_data{ glad_glBufferData };
+        auto buffer_sub_data{ glad_glBufferSubData };
+        auto get_error{ glad_glGetError };
+        glad_glGenBuffers = StubGenBuffers;
+        glad_glDeleteBuffers = StubDeleteBuffers;
+        glad_glBindBuffer = StubBindBuffer;
+        glad_glBufferData = StubBufferData;
+        glad_glBufferSubData = StubBufferSubData;
+        glad_glGetError = StubGetError;
+        {
+            UniformBlock<ViewBlock> block{};
+            results.push_back(Measure("std140/uniform_block_set_upload", ITERATIONS, [&]()
+            {
+                // what changes every frame: the camera and the time, the lights stay
+                block.Set(&ViewBlock::view, view);
+                block.Set(&ViewBlock::eye, glm::vec3{ view[3] });
+                block.Set(&ViewBlock::time, (time += 0.01f));
+                block.Upload();
+            }));
+        }
+        glad_glGenBuffers = gen_buffers;
+        glad_glDeleteBuffers = delete_buffers;
+        glad_glBindBuffer = bind_buffer;
+        glad_glBufferData = buffer_data;
+        glad_glBufferSubData = buffer_sub_data;
+        glad_glGetError = get_error;
+    }
+}
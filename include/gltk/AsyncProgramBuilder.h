@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <gltk/ProgramCache.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gltk
+{
+    struct ProgramSources
+    {
+        std::string vertex{};
+        std::string geometry{}; // optional
+        std::string fragment{};
+    };
+
+    class AsyncProgram
+    {
+        friend class AsyncProgramBuilder;
+    private:
+        enum class Status { Compiling, Linking, Succeeded, Failed };
+        struct State
+        {
+            Status status;
+            std::uint64_t key;
+            std::chrono::nanoseconds build_time; // spent compiling and linking, not waiting in the queue
+            GLuint shader[3];
+            GLuint program;
+            std::string info_log;
+        };
+    private:
+        explicit AsyncProgram(std::shared_ptr<State> state) : m_state{ std::move(state) } {}
+    public:
+        AsyncProgram() = default;
+    public:
+        bool Valid() const noexcept { return m_state != nullptr; }
+        bool Ready() const noexcept { return m_state && (m_state->status == Status::Succeeded || m_state->status == Status::Failed); }
+        bool Failed() const noexcept { return m_state && m_state->status == Status::Failed; }
+        GLuint Program() const noexcept { return m_state && m_state->status == Status::Succeeded ? m_state->program : 0; }
+        std::string InfoLog() const { return m_state ? m_state->info_log : std::string{}; }
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Submits compile and link jobs without querying their status, so that the driver can work on many programs
+    // at once. Poll, called once per frame, advances the jobs that the driver reports as complete
+    // (KHR_parallel_shader_compile). Without the extension every status query blocks, so Poll only advances
+    // a bounded number of jobs per call to spread the stall across frames.
+    class AsyncProgramBuilder
+    {
+    public:
+        explicit AsyncProgramBuilder(ProgramCache* cache = nullptr, int max_blocking_steps_per_poll = 4);
+        ~AsyncProgramBuilder() noexcept;
+        AsyncProgramBuilder(const AsyncProgramBuilder&) = delete;
+        AsyncProgramBuilder(AsyncProgramBuilder&&) noexcept = delete;
+        AsyncProgramBuilder& operator=(const AsyncProgramBuilder&) = delete;
+        AsyncProgramBuilder& operator=(AsyncProgramBuilder&&) noexcept = delete;
+    public:
+        bool Parallel() const noexcept { return m_parallel; }
+        int Pending() const noexcept { return static_cast<int>(m_pending.size()); }
+    public:
+        AsyncProgram Submit(const ProgramSources& sources);
+        int Poll();
+    private:
+        bool IsComplete(const AsyncProgram::State& state) const;
+        void FinishCompile(AsyncProgram::State& state);
+        void FinishLink(AsyncProgram::State& state);
+        void DeleteShaders(AsyncProgram::State& state);
+    private:
+        constexpr static int INFO_LOG_SIZE{ 1024 };
+    private:
+        ProgramCache* m_cache;
+        bool m_parallel;
+        int m_max_blocking_steps_per_poll;
+        std::vector<std::shared_ptr<AsyncProgram::State>> m_pending;
+    };
+}
@@ -3,3 +3,19 @@
 #include <gltk/Crash.h>
 
 #define gltk_Check(p) do { if (!(p)) gltk_Crash("Check failed: '" #p "'"); } while (false)
+// non-throwing check for hot paths and recoverable failures: reports the failure and evaluates to p
+#define gltk_Verify(p) ::gltk::Verify(static_cast<bool>(p), __FILE__, __LINE__, "Verify failed: '" #p "'")
+
+namespace gltk
+{
+    void ReportVerifyFailure(const char* file, int line, const char* message);
+
+    inline bool Verify(bool success, const char* file, int line, const char* message)
+    {
+        if (!success) [[unlikely]]
+        {
+            ReportVerifyFailure(file, line, message);
+        }
+        return success;
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <scope_guard.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gltk
+{
+    // Deferred calls recorded on one thread and executed on another, typically GL work recorded by the update
+    // thread for the thread owning the context. Commands are stored in place in blocks that are kept across frames,
+    // so recording does not allocate once the blocks are warm, and are destroyed right after they run.
+    class CommandList
+    {
+    public:
+        constexpr static std::size_t BLOCK_SIZE{ 64 * 1024 };
+    public:
+        CommandList();
+        ~CommandList() noexcept;
+        CommandList(const CommandList&) = delete;
+        CommandList(CommandList&&) noexcept = delete;
+        CommandList& operator=(const CommandList&) = delete;
+        CommandList& operator=(CommandList&&) noexcept = delete;
+    public:
+        std::uint64_t Frame() const noexcept { return m_frame; }
+        std::chrono::steady_clock::time_point InputTime() const noexcept { return m_input_time; } // of the input the frame reacts to
+        int Count() const noexcept { return static_cast<int>(m_commands.size()); }
+        std::size_t Bytes() const noexcept { return m_bytes; }
+    public:
+        void Stamp(std::uint64_t frame, std::chrono::steady_clock::time_point input_time) noexcept { m_frame = frame; m_input_time = input_time; }
+        template <typename F>
+        void Record(F&& f)
+        {
+            using Command = std::decay_t<F>;
+            static_assert(alignof(Command) <= alignof(std::max_align_t));
+            void* storage{ Allocate(sizeof(Command), alignof(Command)) };
+            Command* command{ ::new (storage) Command(std::forward<F>(f)) };
+            m_commands.push_back({ &Invoke<Command>, command });
+        }
+        void Execute(); // runs the commands in order and clears the list, even if one of them throws
+        void Clear();   // destroys the commands without running them
+    private:
+        template <typename Command>
+        static void Invoke(void* ptr, bool run)
+        {
+            Command* command{ static_cast<Command*>(ptr) };
+            auto destroy_on_exit{ sg::make_scope_guard([command]() { command->~Command(); }) };
+            if (run)
+            {
+                (*command)();
+            }
+        }
+        void* Allocate(std::size_t size, std::size_t alignment);
+    private:
+        struct Entry
+        {
+            void (*invoke)(void*, bool);
+            void* command;
+        };
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t size;
+        };
+    private:
+        std::vector<Entry> m_commands;
+        std::size_t m_next;       // first command not run or destroyed yet
+        std::vector<Block> m_blocks;
+        std::size_t m_block_idx;  // block being filled
+        std::size_t m_block_offset;
+        std::size_t m_bytes;
+        std::uint64_t m_frame;
+        std::chrono::steady_clock::time_point m_input_time;
+    };
+
+    struct CommandQueueStats
+    {
+        std::int64_t published;            // lists handed to the replaying thread
+        std::chrono::nanoseconds record_wait; // recording thread blocked on a list still being replayed
+        std::chrono::nanoseconds replay_wait; // replaying thread idle, waiting for a list
+    };
+
+    // Double-buffered command lists passed from one recording thread to one replaying thread. The two lists change
+    // hands through atomic state transitions (waiting with atomic wait/notify, no locks), in strict alternation,
+    // so the recording thread can run at most one frame ahead of the replaying one.
+    class CommandQueue
+    {
+    public:
+        CommandQueue();
+        ~CommandQueue() noexcept = default;
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue(CommandQueue&&) noexcept = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+        CommandQueue& operator=(CommandQueue&&) noexcept = delete;
+    public:
+        CommandQueueStats Stats() const noexcept; // safe from any thread
+    public:
+        // each Begin waits for its list and returns nullptr once the queue is closed
+        CommandList* BeginRecord();
+        void EndRecord();
+        CommandList* BeginReplay();
+        void EndReplay();
+        void Close(); // wakes up and stops both threads
+    private:
+        enum class SlotState { Free, Recording, Ready, Replaying, Closed };
+    private:
+        bool Transition(int slot, SlotState from, SlotState to, std::atomic<std::int64_t>& wait_ns);
+    private:
+        CommandList m_lists[2];
+        std::atomic<SlotState> m_states[2];
+        int m_record_idx; // only touched by the recording thread
+        int m_replay_idx; // only touched by the replaying thread
+        std::atomic<std::int64_t> m_published;
+        std::atomic<std::int64_t> m_record_wait_ns;
+        std::atomic<std::int64_t> m_replay_wait_ns;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stacktrace>
 #include <string>
 
 #define gltk_Crash(msg) do { ::gltk::TryDebugBreak(); throw ::gltk::Crash{ __FILE__, __LINE__, msg }; } while (false)
@@ -10,11 +11,17 @@ namespace gltk
     class Crash
     {
     public:
-        Crash(const std::string& file, int line, const std::string message);
+        // only the raw frames are captured here, symbolizing them is deferred to the first What call
+        Crash(const char* file, int line, std::string message);
     public:
-        const std::string& What() const noexcept { return m_what; }
+        const std::string& What() const;
+        const std::string& Message() const noexcept { return m_message; }
     private:
-        std::string m_what;
+        const char* m_file;
+        int m_line;
+        std::string m_message;
+        std::stacktrace m_stacktrace;
+        mutable std::string m_what;
     };
 
     void TryDebugBreak();
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace gltk
+{
+    struct FrameMemoryStats
+    {
+        std::int64_t allocations;
+        std::int64_t deallocations;
+        std::int64_t upstream_allocations; // allocations that the resource could not serve itself
+        std::size_t bytes;                 // requested
+        std::size_t peak;                  // most bytes held at once, padding included
+    };
+
+    // Linear allocator for data that lives until the end of the frame. Allocating bumps an offset, deallocating
+    // does nothing unless it is the last allocation (so that a growing vector reuses its tail), and Reset releases
+    // everything at once. A frame that does not fit spills into upstream blocks, and the next Reset grows the
+    // arena so that the following frames fit again. Not thread safe.
+    class FrameArena : public std::pmr::memory_resource
+    {
+    public:
+        constexpr static std::size_t DEFAULT_CAPACITY{ 1024 * 1024 };
+    public:
+        explicit FrameArena(std::size_t capacity = DEFAULT_CAPACITY, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~FrameArena() noexcept override;
+        FrameArena(const FrameArena&) = delete;
+        FrameArena(FrameArena&&) noexcept = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        FrameArena& operator=(FrameArena&&) noexcept = delete;
+    public:
+        std::size_t Capacity() const noexcept { return m_capacity; }
+        std::size_t HighWater() const noexcept { return m_high_water; } // largest frame peak so far
+        const FrameMemoryStats& Stats() const noexcept { return m_stats; } // of the frame so far
+        const FrameMemoryStats& LastFrame() const noexcept { return m_last_frame; }
+    public:
+        void Reset();
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    private:
+        struct Spill
+        {
+            void* ptr;
+            std::size_t size;
+            std::size_t alignment;
+        };
+    private:
+        std::pmr::memory_resource* m_upstream;
+        std::byte* m_buffer;
+        std::size_t m_capacity;
+        std::size_t m_offset;
+        std::size_t m_last_offset; // where the last allocation started, for LIFO deallocation
+        std::size_t m_spilled;
+        std::vector<Spill> m_spills;
+        std::size_t m_high_water;
+        FrameMemoryStats m_stats;
+        FrameMemoryStats m_last_frame;
+    };
+
+    // Fixed-size blocks in power of two size classes, carved from chunks that are kept across frames. Freed blocks
+    // are reused within the frame and Reset makes every block free again, so after the first frames nothing
+    // reaches the upstream resource. Larger or over-aligned allocations are forwarded upstream, and released by
+    // Reset too if they were not deallocated. Not thread safe.
+    class FramePool : public std::pmr::memory_resource
+    {
+    public:
+        constexpr static std::size_t MIN_BLOCK_SIZE{ 16 };
+        constexpr static std::size_t MAX_BLOCK_SIZE{ 512 };
+        constexpr static std::size_t CHUNK_SIZE{ 64 * 1024 };
+    public:
+        explicit FramePool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~FramePool() noexcept override;
+        FramePool(const FramePool&) = delete;
+        FramePool(FramePool&&) noexcept = delete;
+        FramePool& operator=(const FramePool&) = delete;
+        FramePool& operator=(FramePool&&) noexcept = delete;
+    public:
+        std::size_t Reserved() const noexcept; // chunk memory held
+        std::size_t HighWater() const noexcept { return m_high_water; }
+        const FrameMemoryStats& Stats() const noexcept { return m_stats; }
+        const FrameMemoryStats& LastFrame() const noexcept { return m_last_frame; }
+    public:
+        void Reset();
+    private:
+        static int SizeClassIdx(std::size_t bytes, std::size_t alignment) noexcept;
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    private:
+        struct LargeBlock
+        {
+            void* ptr;
+            std::size_t size;
+            std::size_t alignment;
+        };
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+        struct SizeClass
+        {
+            FreeBlock* free;
+            std::vector<std::byte*> chunks;
+            std::size_t chunk_idx;   // chunk being carved
+            std::size_t carve_offset;
+        };
+    private:
+        constexpr static int SIZE_CLASS_COUNT{ 6 }; // 16 to 512
+    private:
+        std::pmr::memory_resource* m_upstream;
+        SizeClass m_classes[SIZE_CLASS_COUNT];
+        std::vector<LargeBlock> m_large;
+        std::size_t m_in_use;
+        std::size_t m_high_water;
+        FrameMemoryStats m_stats;
+        FrameMemoryStats m_last_frame;
+    };
+}
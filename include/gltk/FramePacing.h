@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace gltk
+{
+    struct FramePacingStats
+    {
+        std::int64_t frames;        // presented since the start
+        double interval_mean_ms;    // between consecutive presents
+        double interval_stddev_ms;
+        double interval_p99_ms;
+        double latency_mean_ms;     // from sampling the input a frame reacts to until that frame is presented
+        double latency_p99_ms;
+    };
+
+    // Present-to-present intervals and input-to-present latencies over the last WINDOW frames. Present is meant to
+    // be called by the presenting thread right after swapping buffers, Stats can be called from any thread.
+    class FramePacing
+    {
+    public:
+        constexpr static int WINDOW{ 240 };
+    public:
+        FramePacing();
+        ~FramePacing() noexcept = default;
+        FramePacing(const FramePacing&) = delete;
+        FramePacing(FramePacing&&) noexcept = delete;
+        FramePacing& operator=(const FramePacing&) = delete;
+        FramePacing& operator=(FramePacing&&) noexcept = delete;
+    public:
+        FramePacingStats Stats() const;
+    public:
+        void Present(std::chrono::steady_clock::time_point input_time);
+    private:
+        mutable std::mutex m_mutex;
+        std::int64_t m_frames;
+        std::chrono::steady_clock::time_point m_last_present;
+        std::vector<double> m_intervals_ms; // rings of WINDOW samples
+        std::vector<double> m_latencies_ms;
+    };
+}
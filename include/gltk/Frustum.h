@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace gltk
+{
+    // left, right, bottom, top, near, far planes of a view-projection matrix (Gribb-Hartmann), normalized so that
+    // plane distances are world space distances and compare with radii
+    inline void ExtractFrustumPlanes(const glm::mat4& view_proj, glm::vec4 (&planes)[6])
+    {
+        glm::mat4 rows{ glm::transpose(view_proj) };
+        planes[0] = rows[3] + rows[0];
+        planes[1] = rows[3] - rows[0];
+        planes[2] = rows[3] + rows[1];
+        planes[3] = rows[3] - rows[1];
+        planes[4] = rows[3] + rows[2];
+        planes[5] = rows[3] - rows[2];
+        for (glm::vec4& plane : planes)
+        {
+            plane /= glm::length(glm::vec3{ plane });
+        }
+    }
+}
@@ -1,8 +1,55 @@
 #pragma once
 
+// gltk_GLCheck policies, selected with GLTK_GL_CHECK_MODE:
+// - GLTK_GL_CHECK_PER_CALL: glGetError after every call (default without NDEBUG)
+// - GLTK_GL_CHECK_DEFERRED: calls only record their call site, errors are fetched by gltk_GLCheckpoint
+//   and attributed to the calls made since the previous checkpoint
+// - GLTK_GL_CHECK_NONE: no checking at all (default with NDEBUG)
+#define GLTK_GL_CHECK_NONE 0
+#define GLTK_GL_CHECK_PER_CALL 1
+#define GLTK_GL_CHECK_DEFERRED 2
+
+#if !defined(GLTK_GL_CHECK_MODE)
+#if defined(NDEBUG)
+#define GLTK_GL_CHECK_MODE GLTK_GL_CHECK_NONE
+#else
+#define GLTK_GL_CHECK_MODE GLTK_GL_CHECK_PER_CALL
+#endif
+#endif
+
+#if GLTK_GL_CHECK_MODE == GLTK_GL_CHECK_PER_CALL
 #define gltk_GLCheck(call) (call); ::gltk::PrintGLErrorsIfAny(__FILE__, __LINE__)
+#define gltk_GLCheckpoint() ::gltk::PrintGLErrorsIfAny(__FILE__, __LINE__)
+#elif GLTK_GL_CHECK_MODE == GLTK_GL_CHECK_DEFERRED
+#define gltk_GLCheck(call) (call); ::gltk::RecordGLCall(__FILE__, __LINE__)
+#define gltk_GLCheckpoint() ::gltk::CheckGLCalls(__FILE__, __LINE__)
+#elif GLTK_GL_CHECK_MODE == GLTK_GL_CHECK_NONE
+#define gltk_GLCheck(call) (call)
+#define gltk_GLCheckpoint() do {} while (false)
+#else
+#error "unknown GLTK_GL_CHECK_MODE"
+#endif
 
 namespace gltk
 {
+    struct GLCallSite
+    {
+        const char* file;
+        int line;
+    };
+
+    inline GLCallSite g_first_unchecked_gl_call{};
+    inline GLCallSite g_last_unchecked_gl_call{};
+
+    inline void RecordGLCall(const char* file, int line) noexcept
+    {
+        if (!g_first_unchecked_gl_call.file)
+        {
+            g_first_unchecked_gl_call = { file, line };
+        }
+        g_last_unchecked_gl_call = { file, line };
+    }
+
     void PrintGLErrorsIfAny(const char* file, int line);
+    void CheckGLCalls(const char* file, int line);
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+namespace gltk
+{
+    struct GLStateCacheStats
+    {
+        std::int64_t binds;         // binds forwarded to GL
+        std::int64_t binds_avoided; // binds skipped because GL already had that object bound
+        std::int64_t texture_binds; // of binds, the texture ones
+    };
+
+    // Shadows the GL binding state that draw submission touches, so that redundant binds never reach the driver.
+    // Anything that binds behind its back must be followed by Invalidate.
+    class GLStateCache
+    {
+    private:
+        static int GetTextureTargetIdx(GLenum target);
+    public:
+        GLStateCache();
+        ~GLStateCache() noexcept = default;
+        GLStateCache(const GLStateCache&) = delete;
+        GLStateCache(GLStateCache&&) noexcept = delete;
+        GLStateCache& operator=(const GLStateCache&) = delete;
+        GLStateCache& operator=(GLStateCache&&) noexcept = delete;
+    public:
+        const GLStateCacheStats& Stats() const noexcept { return m_stats; }
+        void ResetStats() noexcept { m_stats = {}; }
+    public:
+        void UseProgram(GLuint program);
+        void BindVertexArray(GLuint vao);
+        void BindArrayBuffer(GLuint buffer);
+        void BindTexture(int unit, GLenum target, GLuint texture);
+        void Invalidate();
+        void InvalidateArrayBuffer() noexcept { m_array_buffer = UNKNOWN; } // after something else bound GL_ARRAY_BUFFER
+    public:
+        constexpr static int MAX_TEXTURE_UNITS{ 16 };
+    private:
+        constexpr static int MAX_TEXTURE_TARGET_INDEX{ 4 };
+        constexpr static GLuint UNKNOWN{ 0xFFFFFFFF };
+    private:
+        GLuint m_program;
+        GLuint m_vao;
+        GLuint m_array_buffer;
+        int m_active_texture;
+        GLuint m_texture[MAX_TEXTURE_UNITS][MAX_TEXTURE_TARGET_INDEX];
+        GLStateCacheStats m_stats;
+    };
+}
@@ -1,6 +1,30 @@
 #pragma once
 
+#include <gltk/AsyncProgramBuilder.h>
+#include <gltk/CommandList.h>
 #include <gltk/Crash.h>
 #include <gltk/Check.h>
+#include <gltk/FrameMemory.h>
+#include <gltk/FramePacing.h>
+#include <gltk/Frustum.h>
 #include <gltk/GLCheck.h>
+#include <gltk/GLStateCache.h>
+#include <gltk/GltfLoader.h>
+#include <gltk/Hash.h>
+#include <gltk/MappedFile.h>
+#include <gltk/MeshFile.h>
+#include <gltk/MeshOptimizer.h>
+#include <gltk/OcclusionCuller.h>
+#include <gltk/Profiler.h>
 #include <gltk/ProgramBuilder.h>
+#include <gltk/ProgramCache.h>
+#include <gltk/RenderQueue.h>
+#include <gltk/RenderTarget.h>
+#include <gltk/SceneBuffer.h>
+#include <gltk/ShaderLibrary.h>
+#include <gltk/Std140.h>
+#include <gltk/StreamBuffer.h>
+#include <gltk/TextureArrays.h>
+#include <gltk/TextureLoader.h>
+#include <gltk/ThreadPool.h>
+#include <gltk/UniformBuffer.h>
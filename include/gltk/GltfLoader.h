@@ -0,0 +1,93 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <tiny_gltf.h>
+
+#include <gltk/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gltk
+{
+    enum class AssetStage { Parsing, Decoding, Uploading, Ready, Failed };
+
+    struct AssetTimings
+    {
+        std::chrono::nanoseconds parse;       // json, buffers and image headers (worker thread)
+        std::chrono::nanoseconds decode;      // wall time from the end of parsing to the last decoded image
+        std::chrono::nanoseconds decode_cpu;  // sum of the time spent decoding each image, across workers
+        std::chrono::nanoseconds wait;        // time spent waiting for the context thread to pick up the upload
+        std::chrono::nanoseconds upload;      // GL uploads (context thread)
+        std::chrono::nanoseconds total;
+    };
+
+    class GltfAsset
+    {
+        friend class GltfLoader;
+    private:
+        struct State
+        {
+            std::filesystem::path path;
+            std::atomic<AssetStage> stage;
+            std::atomic<int> images_decoded;
+            int images_total;
+            std::atomic<std::int64_t> decode_cpu_ns;
+            std::chrono::steady_clock::time_point start_time;
+            std::chrono::steady_clock::time_point parsed_time;
+            std::chrono::steady_clock::time_point decoded_time;
+            AssetTimings timings;
+            std::string error;
+            tinygltf::Model model;
+            std::vector<GLuint> buffers;
+            std::vector<GLuint> textures;
+        };
+    private:
+        explicit GltfAsset(std::shared_ptr<State> state) : m_state{ std::move(state) } {}
+    public:
+        GltfAsset() = default;
+    public:
+        bool Valid() const noexcept { return m_state != nullptr; }
+        const std::filesystem::path& Path() const noexcept { return m_state->path; }
+        AssetStage Stage() const noexcept { return m_state->stage.load(std::memory_order_acquire); }
+        float Progress() const noexcept;
+        // the accessors below are only meaningful once Stage() is Ready (or Failed for Error)
+        const AssetTimings& Timings() const noexcept { return m_state->timings; }
+        const std::string& Error() const noexcept { return m_state->error; }
+        const tinygltf::Model& Model() const noexcept { return m_state->model; }
+        const std::vector<GLuint>& Buffers() const noexcept { return m_state->buffers; } // per buffer view, 0 if not a vertex/index buffer
+        const std::vector<GLuint>& Textures() const noexcept { return m_state->textures; } // per image, 0 if it failed to decode
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Parses glTF files and decodes their images on a thread pool. Only Update, which must be called on the thread
+    // owning the OpenGL context, touches GL: it uploads the buffer views and images of the assets that are decoded.
+    class GltfLoader
+    {
+    public:
+        explicit GltfLoader(ThreadPool& pool);
+        ~GltfLoader() noexcept = default;
+        GltfLoader(const GltfLoader&) = delete;
+        GltfLoader(GltfLoader&&) noexcept = delete;
+        GltfLoader& operator=(const GltfLoader&) = delete;
+        GltfLoader& operator=(GltfLoader&&) noexcept = delete;
+    public:
+        int Pending() const noexcept { return static_cast<int>(m_pending.size()); }
+    public:
+        GltfAsset Load(const std::filesystem::path& path);
+        int Update(int max_uploads = 1);
+        void Unload(GltfAsset& asset);
+    private:
+        static void Parse(ThreadPool& pool, const std::shared_ptr<GltfAsset::State>& state);
+        static void Decode(const std::shared_ptr<GltfAsset::State>& state, int image_idx);
+        static void Upload(GltfAsset::State& state);
+    private:
+        ThreadPool& m_pool;
+        std::vector<std::shared_ptr<GltfAsset::State>> m_pending;
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gltk
+{
+    // 64-bit FNV-1a, used to address on-disk cache entries
+    constexpr std::uint64_t FNV_OFFSET_BASIS{ 0xcbf29ce484222325ull };
+    constexpr std::uint64_t FNV_PRIME{ 0x100000001b3ull };
+
+    inline std::uint64_t HashBytes(std::uint64_t hash, const void* data, std::size_t size)
+    {
+        const unsigned char* bytes{ static_cast<const unsigned char*>(data) };
+        for (std::size_t i{}; i < size; i++)
+        {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace gltk
+{
+    // Read-only memory mapping of a whole file. Valid() is false if the file could not be opened or mapped.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::filesystem::path& path);
+        ~MappedFile() noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) noexcept = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) noexcept = delete;
+    public:
+        bool Valid() const noexcept { return m_data != nullptr; }
+        std::span<const std::byte> Data() const noexcept { return { m_data, m_size }; }
+        std::size_t Size() const noexcept { return m_size; }
+    private:
+        const std::byte* m_data;
+        std::size_t m_size;
+        #if defined(_WIN32)
+        void* m_file;
+        void* m_mapping;
+        #endif
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <gltk/MappedFile.h>
+#include <gltk/SceneBuffer.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace gltk
+{
+    // quantized vertex of a mesh file, 16 bytes
+    struct PackedVertex
+    {
+        std::uint16_t position[4]; // half floats, w is 1
+        std::int16_t normal[2];    // octahedral, snorm
+        std::uint16_t uv[2];       // unorm over the uv range of the mesh (MeshFileHeader::uv_offset and uv_scale)
+    };
+    static_assert(sizeof(PackedVertex) == 16);
+
+    // A mesh file is this header followed by the packed vertices and the indices, each 16 byte aligned and laid
+    // out exactly as the GL buffers want them, so that loading is a mapping and two buffer uploads.
+    struct MeshFileHeader
+    {
+        char magic[8];               // MESH_FILE_MAGIC
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+        std::uint32_t index_type;    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+        std::uint32_t vertex_stride; // sizeof(PackedVertex)
+        float uv_offset[2];
+        float uv_scale[2];
+        float center[3];             // bounding sphere
+        float radius;
+        std::uint64_t vertex_offset; // from the start of the file
+        std::uint64_t index_offset;
+    };
+
+    constexpr char MESH_FILE_MAGIC[8]{ 'G', 'L', 'T', 'K', 'M', 'S', 'H', '1' };
+
+    // Memory mapped mesh file. Valid() is false if the file could not be mapped, or its header or its indices do not
+    // check out.
+    class MeshFile
+    {
+    public:
+        explicit MeshFile(const std::filesystem::path& path);
+        ~MeshFile() noexcept = default;
+        MeshFile(const MeshFile&) = delete;
+        MeshFile(MeshFile&&) noexcept = delete;
+        MeshFile& operator=(const MeshFile&) = delete;
+        MeshFile& operator=(MeshFile&&) noexcept = delete;
+    public:
+        bool Valid() const noexcept { return m_header != nullptr; }
+        const MeshFileHeader& Header() const noexcept { return *m_header; }
+        std::span<const std::byte> Vertices() const noexcept;
+        std::span<const std::byte> Indices() const noexcept;
+        std::size_t Size() const noexcept { return m_file.Size(); }
+    private:
+        MappedFile m_file;
+        const MeshFileHeader* m_header;
+    };
+
+    // GL buffers and vertex array of a mesh file. The attributes are left quantized, a vertex shader decodes them:
+    //
+    //     layout (location = 0) in vec4 aPosition; // GL_HALF_FLOAT
+    //     layout (location = 1) in vec2 aNormal;   // octahedral, GL_SHORT normalized
+    //     layout (location = 2) in vec2 aUV;       // GL_UNSIGNED_SHORT normalized
+    //     uniform vec4 uUVTransform;               // UVOffset() in xy, UVScale() in zw
+    //
+    //     vec3 DecodeOctahedral(vec2 e)
+    //     {
+    //         vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    //         float t = max(-n.z, 0.0);
+    //         n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    //         return normalize(n);
+    //     }
+    //     vec2 uv = uUVTransform.xy + aUV * uUVTransform.zw;
+    class GpuMesh
+    {
+    public:
+        constexpr static GLuint POSITION_ATTRIB{ 0 };
+        constexpr static GLuint NORMAL_ATTRIB{ 1 };
+        constexpr static GLuint UV_ATTRIB{ 2 };
+    public:
+        explicit GpuMesh(const MeshFile& file);
+        ~GpuMesh() noexcept;
+        GpuMesh(const GpuMesh&) = delete;
+        GpuMesh(GpuMesh&&) noexcept = delete;
+        GpuMesh& operator=(const GpuMesh&) = delete;
+        GpuMesh& operator=(GpuMesh&&) noexcept = delete;
+    public:
+        GLuint VertexArray() const noexcept { return m_vao; }
+        GLsizei Count() const noexcept { return m_count; }
+        GLenum IndexType() const noexcept { return m_index_type; }
+        glm::vec2 UVOffset() const noexcept { return m_uv_offset; }
+        glm::vec2 UVScale() const noexcept { return m_uv_scale; }
+        SceneMesh AsSceneMesh() const noexcept;
+    private:
+        GLuint m_vbo;
+        GLuint m_ebo;
+        GLuint m_vao;
+        GLsizei m_count;
+        GLenum m_index_type;
+        glm::vec2 m_uv_offset;
+        glm::vec2 m_uv_scale;
+        glm::vec3 m_center;
+        float m_radius;
+    };
+}
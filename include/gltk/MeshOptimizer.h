@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <tiny_gltf.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace gltk
+{
+    // indexed triangle list; normals and uvs are either empty or one per position
+    struct MeshData
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<std::uint32_t> indices;
+    };
+
+    struct VertexCacheStats
+    {
+        float acmr; // average cache miss ratio, vertex shader invocations per triangle (0.5 at best, 3 at worst)
+        float atvr; // average transformed vertex ratio, vertex shader invocations per vertex (1 at best)
+    };
+
+    struct MeshStats
+    {
+        std::uint32_t vertices;
+        std::uint32_t triangles;
+        VertexCacheStats before;
+        VertexCacheStats after;
+        std::size_t input_bytes;  // float attributes and 32-bit indices, as they come out of a typical glTF
+        std::size_t output_bytes; // mesh file
+        std::chrono::nanoseconds time;
+    };
+
+    // FIFO cache simulation, with a cache size matching common hardware
+    VertexCacheStats ComputeVertexCacheStats(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, int cache_size = 16);
+
+    // Reorders triangles for post-transform cache hits (Forsyth's linear-speed vertex cache optimization).
+    void OptimizeVertexCache(std::span<std::uint32_t> indices, std::uint32_t vertex_count);
+    // Splits cache optimized indices into clusters where the cache restarts and sorts the clusters so that the ones
+    // facing outwards are drawn first, which lets early depth testing reject more of what comes after.
+    void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const glm::vec3> positions, int cache_size = 16);
+    // Reorders vertices in the order the indices first use them, and drops unused ones.
+    void OptimizeVertexFetch(MeshData& mesh);
+    // all of the above, in the order they have to run
+    MeshStats OptimizeMesh(MeshData& mesh);
+
+    bool ExtractGltfPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive, MeshData& mesh, std::string& error);
+
+    // quantizes the mesh into the MeshFile layout
+    std::size_t MeshFileSize(const MeshData& mesh);
+    std::vector<std::byte> EncodeMeshFile(const MeshData& mesh);
+    bool WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace gltk
+{
+    struct OcclusionStats
+    {
+        int objects;
+        int groups;
+        int frustum_culled;  // objects outside the frustum, not drawn at all
+        int occluded;        // objects hidden by their last query result, only drawn under conditional rendering
+        int drawn;           // objects drawn unconditionally, visible last time or with their result still pending
+        int queries;         // issued this frame, bounding boxes and object draws
+        int proxy_queries;   // of queries, the bounding boxes drawn with color and depth writes off
+        int group_queries;   // of proxy_queries, the ones standing for a whole group
+        int results_read;
+        int queries_pending; // results that were not available yet, which the CPU did not wait for
+        std::chrono::nanoseconds cpu_time;
+    };
+
+    // Occlusion culling with GL_ANY_SAMPLES_PASSED queries read back a frame late, hidden objects being drawn under
+    // conditional rendering on a query of their bounding box; groups of GROUP_SIZE objects are tested as one box.
+    class OcclusionCuller
+    {
+    public:
+        constexpr static std::uint32_t GROUP_SIZE{ 8 };
+    public:
+        OcclusionCuller();
+        ~OcclusionCuller() noexcept;
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller(OcclusionCuller&&) noexcept = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&&) noexcept = delete;
+    public:
+        std::uint32_t ObjectCount() const noexcept { return static_cast<std::uint32_t>(m_objects.size()); }
+        bool Visible(std::uint32_t object) const noexcept { return m_objects[object].visible; } // last known result
+        const OcclusionStats& Stats() const noexcept { return m_stats; } // of the last Render
+    public:
+        std::uint32_t Add(const glm::vec3& min, const glm::vec3& max); // world space bounding box
+        void SetBounds(std::uint32_t object, const glm::vec3& min, const glm::vec3& max); // keeps its group
+        // draw must not start queries or conditional rendering; expects depth testing, binds its own program and vao
+        void Render(const glm::mat4& view_proj, const std::function<void(std::uint32_t)>& draw);
+    private:
+        struct Node
+        {
+            glm::vec3 min;
+            glm::vec3 max;
+            GLuint query;
+            bool visible;
+            bool pending; // query issued and its result not read yet
+        };
+        struct Group
+        {
+            Node node;
+            std::uint32_t first; // into m_order
+            std::uint32_t count;
+        };
+    private:
+        void BuildHierarchy();
+        void ReadResults();
+        void RenderGroup(Group& group, const std::function<void(std::uint32_t)>& draw);
+        void DrawProxy(const Node& node);
+        void BeginProxies();
+        void EndProxies();
+        bool InFrustum(const Node& node) const;
+        bool BeyondNearPlane(const Node& node) const;
+    private:
+        GLuint m_program;
+        GLuint m_vao;
+        GLint m_view_proj_location;
+        GLint m_min_location;
+        GLint m_max_location;
+        std::vector<Node> m_objects;
+        std::vector<Group> m_groups;
+        std::vector<std::uint32_t> m_order;       // objects in Morton order, groups are consecutive runs of it
+        std::vector<std::uint32_t> m_group_order; // groups sorted front to back, by Render
+        std::vector<float> m_group_depth;
+        std::vector<std::uint32_t> m_object_group;
+        std::vector<std::uint8_t> m_object_in_frustum; // scratch for RenderGroup
+        bool m_hierarchy_dirty;
+        glm::vec4 m_planes[6];
+        GLboolean m_color_mask[4]; // of the caller, put back after the boxes
+        GLboolean m_depth_mask;
+        GLboolean m_cull_face;
+        OcclusionStats m_stats;
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <vector>
+
+#define gltk_ProfileConcatImpl(a, b) a##b
+#define gltk_ProfileConcat(a, b) gltk_ProfileConcatImpl(a, b)
+#if defined(GLTK_DISABLE_PROFILER)
+#define gltk_ProfileZone(name) do {} while (false)
+#else
+#define gltk_ProfileZone(name) ::gltk::ProfileScope gltk_ProfileConcat(gltk_profile_scope_, __LINE__){ name }
+#endif
+
+namespace gltk
+{
+    struct ProfileZone
+    {
+        const char* name; // must outlive the profiler, typically a string literal
+        int parent;       // index of the enclosing zone in the same frame, -1 for the frame itself
+        int depth;
+        std::int64_t cpu_begin_ns; // relative to the beginning of the frame
+        std::int64_t cpu_end_ns;
+        std::int64_t gpu_begin_ns; // relative to the beginning of the frame on the GPU timeline
+        std::int64_t gpu_end_ns;
+        int query; // first of the two timestamp queries of the zone
+    };
+
+    // Records CPU time and GPU time (timestamp queries) of nested zones. Query results are read back
+    // FRAME_LATENCY frames later, once they are available, so the profiler never stalls the pipeline;
+    // frames whose results are still not available by then are dropped.
+    class Profiler
+    {
+    public:
+        static Profiler* Current() noexcept { return s_current; }
+    public:
+        Profiler();
+        ~Profiler() noexcept;
+        Profiler(const Profiler&) = delete;
+        Profiler(Profiler&&) noexcept = delete;
+        Profiler& operator=(const Profiler&) = delete;
+        Profiler& operator=(Profiler&&) noexcept = delete;
+    public:
+        const std::vector<ProfileZone>& LastFrame() const noexcept { return m_last_frame; }
+        int DroppedFrames() const noexcept { return m_dropped_frames; }
+    public:
+        void BeginFrame();
+        void EndFrame();
+        int BeginZone(const char* name);
+        void EndZone(int zone);
+    public:
+        void DrawImGui();
+        bool ExportChromeTrace(const std::filesystem::path& path) const;
+    private:
+        struct Frame
+        {
+            std::vector<ProfileZone> zones;
+            std::vector<GLuint> queries;
+            int used_queries;
+            bool pending;
+            std::int64_t begin_ns; // relative to the profiler creation
+        };
+        struct ResolvedFrame
+        {
+            std::int64_t begin_ns;
+            std::vector<ProfileZone> zones;
+        };
+    private:
+        std::int64_t Now() const;
+        void Resolve(Frame& frame);
+    private:
+        constexpr static int FRAME_LATENCY{ 3 };
+        constexpr static int QUERY_CHUNK{ 64 };
+        constexpr static int MAX_HISTORY_FRAMES{ 600 };
+    private:
+        static inline Profiler* s_current{};
+    private:
+        std::int64_t m_epoch_ns;
+        Frame m_frames[FRAME_LATENCY];
+        int m_frame;
+        bool m_in_frame;
+        std::vector<int> m_stack;
+        std::vector<ProfileZone> m_last_frame;
+        std::deque<ResolvedFrame> m_history;
+        int m_dropped_frames;
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : m_profiler{ Profiler::Current() }
+            , m_zone{ m_profiler ? m_profiler->BeginZone(name) : -1 }
+        {
+        }
+        ~ProfileScope() noexcept
+        {
+            if (m_profiler && m_zone >= 0)
+            {
+                m_profiler->EndZone(m_zone);
+            }
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope(ProfileScope&&) noexcept = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+        ProfileScope& operator=(ProfileScope&&) noexcept = delete;
+    private:
+        Profiler* m_profiler;
+        int m_zone;
+    };
+}
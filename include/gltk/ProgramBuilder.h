@@ -2,6 +2,8 @@
 
 #include <glad/glad.h>
 
+#include <gltk/ProgramCache.h>
+
 #include <string>
 
 namespace gltk
@@ -13,6 +15,8 @@ namespace gltk
         static GLenum GetShaderType(int idx);
     public:
         ProgramBuilder();
+        // with a cache that is enabled, Compile only records the stage sources and compilation happens in Link on a cache miss
+        explicit ProgramBuilder(ProgramCache* cache);
         ~ProgramBuilder() noexcept;
         ProgramBuilder(const ProgramBuilder&) = delete;
         ProgramBuilder(ProgramBuilder&&) noexcept = delete;
@@ -26,6 +30,10 @@ namespace gltk
         GLuint Link();
     public:
         void Delete(GLenum shader_type);
+    private:
+        bool CompileShader(int shader_idx, GLsizei count, const GLchar** lines, const GLint* line_lengths);
+        GLuint LinkShaders(bool retrievable);
+        GLuint LinkCached();
     private:
         constexpr static int INFO_LOG_SIZE{ 1024 };
         constexpr static int MAX_SHADER_INDEX{ 3 };
@@ -33,5 +41,7 @@ namespace gltk
         bool m_status;
         char m_info_log[INFO_LOG_SIZE];
         GLuint m_shader[MAX_SHADER_INDEX];
+        ProgramCache* m_cache;
+        std::string m_source[MAX_SHADER_INDEX];
     };
 }
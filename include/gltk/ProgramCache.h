@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+
+namespace gltk
+{
+    struct ProgramCacheStats
+    {
+        int hits;
+        int misses;
+        int rejects; // entries found on disk but refused by the driver
+        int writes;
+        std::chrono::nanoseconds time_saved;
+    };
+
+    // On-disk cache of linked program binaries (ARB_get_program_binary).
+    // Entries are addressed by a hash of the stage sources and of the GL vendor/renderer/version strings,
+    // so a driver update invalidates them implicitly. Must be created with a current OpenGL context.
+    class ProgramCache
+    {
+    public:
+        ProgramCache(const std::filesystem::path& dir);
+        ~ProgramCache() noexcept = default;
+        ProgramCache(const ProgramCache&) = delete;
+        ProgramCache(ProgramCache&&) noexcept = delete;
+        ProgramCache& operator=(const ProgramCache&) = delete;
+        ProgramCache& operator=(ProgramCache&&) noexcept = delete;
+    public:
+        bool Enabled() const noexcept { return m_enabled; }
+        const ProgramCacheStats& Stats() const noexcept { return m_stats; }
+    public:
+        std::uint64_t Key(std::span<const std::string> stage_sources) const;
+        GLuint Load(std::uint64_t key);
+        void Store(std::uint64_t key, GLuint program, std::chrono::nanoseconds build_time);
+    private:
+        std::filesystem::path EntryPath(std::uint64_t key) const;
+    private:
+        bool m_enabled;
+        std::filesystem::path m_dir;
+        std::string m_driver;
+        ProgramCacheStats m_stats;
+    };
+}
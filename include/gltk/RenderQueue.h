@@ -0,0 +1,91 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <gltk/GLStateCache.h>
+#include <gltk/StreamBuffer.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gltk
+{
+    struct Material
+    {
+        GLuint textures[4]{}; // bound to units 0..3, 0 for unused units
+        GLenum target{ GL_TEXTURE_2D }; // GL_TEXTURE_2D_ARRAY for textures from TextureArrays
+    };
+
+    struct DrawItem
+    {
+        GLuint program{};
+        GLuint vao{};
+        std::uint16_t material{}; // index returned by RenderQueue::AddMaterial, 0 binds no textures
+        float depth{};            // view depth normalized to [0, 1], used to sort front to back
+        GLenum mode{ GL_TRIANGLES };
+        GLsizei count{};
+        GLenum index_type{ GL_NONE }; // GL_NONE for non-indexed draws
+        GLintptr first{};             // first vertex, or byte offset into the element buffer of the vao
+        GLint base_vertex{};
+        // items that only differ by this value are merged into one instanced draw; the shader receives it
+        // through the RenderQueue::INSTANCE_ATTRIB vertex attribute, which the vao must not use otherwise
+        std::uint32_t instance{ 0xFFFFFFFF }; // RenderQueue::NO_INSTANCE
+    };
+
+    struct RenderQueueStats
+    {
+        int items;
+        int draw_calls;
+        int instanced_draws;
+        int multi_draws;
+        std::int64_t state_changes;
+        std::int64_t binds_avoided;
+        std::int64_t texture_binds;
+    };
+
+    // Collects draw items for a frame and submits them in Flush, sorted by a packed 64-bit key
+    // (program, vao, material, depth) so that state changes are minimized. Program and vao names are mapped to dense
+    // per-flush ids for the key, so any GL name fits. Within a state run, items that share
+    // their geometry are merged into an instanced draw, the others into a multi-draw.
+    class RenderQueue
+    {
+    public:
+        constexpr static std::uint32_t NO_INSTANCE{ 0xFFFFFFFF };
+        constexpr static GLuint INSTANCE_ATTRIB{ 15 };
+    public:
+        explicit RenderQueue(GLsizeiptr instance_buffer_size = 1024 * 1024);
+        ~RenderQueue() noexcept = default;
+        RenderQueue(const RenderQueue&) = delete;
+        RenderQueue(RenderQueue&&) noexcept = delete;
+        RenderQueue& operator=(const RenderQueue&) = delete;
+        RenderQueue& operator=(RenderQueue&&) noexcept = delete;
+    public:
+        GLStateCache& State() noexcept { return m_state; }
+        const RenderQueueStats& Stats() const noexcept { return m_stats; } // of the last Flush
+    public:
+        std::uint16_t AddMaterial(const Material& material);
+        void Submit(const DrawItem& item);
+        void Flush();
+    private:
+        std::uint64_t SortKey(const DrawItem& item);
+        void BindState(const DrawItem& item);
+        void DrawInstanced(const DrawItem* const* items, int count);
+        void DrawMulti(const DrawItem* const* items, int count);
+    private:
+        GLStateCache m_state;
+        StreamBuffer m_instances;
+        std::vector<Material> m_materials;
+        std::vector<DrawItem> m_items;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> m_keys;
+        std::unordered_map<GLuint, std::uint16_t> m_program_ids;
+        std::unordered_map<GLuint, std::uint16_t> m_vao_ids;
+        std::vector<const DrawItem*> m_run;
+        std::vector<GLsizei> m_counts;
+        std::vector<GLint> m_firsts;
+        std::vector<const void*> m_offsets;
+        std::vector<GLint> m_base_vertices;
+        RenderQueueStats m_stats;
+    };
+}
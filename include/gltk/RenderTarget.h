@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace gltk
+{
+    // Offscreen framebuffer with an RGBA8 color texture and a depth/stencil renderbuffer, for rendering without
+    // relying on the default framebuffer (e.g. hidden or pbuffer-less windows in headless runs).
+    class RenderTarget
+    {
+    public:
+        RenderTarget(int width, int height);
+        ~RenderTarget() noexcept;
+        RenderTarget(const RenderTarget&) = delete;
+        RenderTarget(RenderTarget&&) noexcept = delete;
+        RenderTarget& operator=(const RenderTarget&) = delete;
+        RenderTarget& operator=(RenderTarget&&) noexcept = delete;
+    public:
+        GLuint Framebuffer() const noexcept { return m_framebuffer; }
+        GLuint ColorTexture() const noexcept { return m_color; }
+        int Width() const noexcept { return m_width; }
+        int Height() const noexcept { return m_height; }
+    public:
+        // binds the framebuffer for drawing and sets the viewport to cover it
+        void Bind();
+    private:
+        int m_width;
+        int m_height;
+        GLuint m_framebuffer;
+        GLuint m_color;
+        GLuint m_depth_stencil;
+    };
+}
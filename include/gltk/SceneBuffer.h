@@ -0,0 +1,99 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <gltk/GLStateCache.h>
+#include <gltk/StreamBuffer.h>
+#include <gltk/ThreadPool.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gltk
+{
+    // indexed geometry shared by instances; meshes that share their vao (and mode and index type) are drawn together
+    struct SceneMesh
+    {
+        GLuint vao{};
+        GLenum mode{ GL_TRIANGLES };
+        GLsizei count{};
+        GLenum index_type{ GL_UNSIGNED_INT };
+        GLintptr first{}; // byte offset into the element buffer of the vao, a multiple of the index size
+        GLint base_vertex{};
+        glm::vec3 center{}; // bounding sphere in mesh space
+        float radius{};
+    };
+
+    struct SceneStats
+    {
+        int instances;
+        int visible;
+        int batches;    // culling batches, spread over the calling thread and the pool
+        int draw_calls;
+        int commands;   // indirect commands, or instanced draws on the fallback path
+        bool indirect;
+        std::chrono::nanoseconds cull_time;
+        std::chrono::nanoseconds draw_time;
+    };
+
+    // Instances of meshes with their bounding spheres stored as structure of arrays for a multithreaded frustum
+    // test; the visible ones are drawn with one multi-draw-indirect per vao, or instanced draws without it.
+    class SceneBuffer
+    {
+    public:
+        constexpr static GLuint TRANSFORM_ATTRIB{ 11 }; // locations 11 to 14
+        constexpr static std::uint32_t BATCH_SIZE{ 4096 };
+    public:
+        explicit SceneBuffer(ThreadPool* pool = nullptr, bool allow_indirect = true, GLsizeiptr stream_size = 16 * 1024 * 1024);
+        ~SceneBuffer() noexcept = default;
+        SceneBuffer(const SceneBuffer&) = delete;
+        SceneBuffer(SceneBuffer&&) noexcept = delete;
+        SceneBuffer& operator=(const SceneBuffer&) = delete;
+        SceneBuffer& operator=(SceneBuffer&&) noexcept = delete;
+    public:
+        bool Indirect() const noexcept { return m_commands.has_value(); }
+        std::uint32_t InstanceCount() const noexcept { return static_cast<std::uint32_t>(m_instance_mesh.size()); }
+        GLStateCache& State() noexcept { return m_state; }
+        const SceneStats& Stats() const noexcept { return m_stats; } // of the last Cull and Draw
+    public:
+        std::uint32_t AddMesh(const SceneMesh& mesh);
+        std::uint32_t AddInstance(std::uint32_t mesh, const glm::mat4& transform);
+        void SetTransform(std::uint32_t instance, const glm::mat4& transform);
+        void Cull(const glm::mat4& view_proj);
+        void Draw(GLuint program);
+    private:
+        void CullBatch(std::uint32_t batch);
+        void BindTransforms(GLintptr offset);
+    private:
+        struct DrawElementsIndirectCommand
+        {
+            GLuint count;
+            GLuint instance_count;
+            GLuint first_index;
+            GLint base_vertex;
+            GLuint base_instance;
+        };
+    private:
+        ThreadPool* m_pool;
+        GLStateCache m_state;
+        StreamBuffer m_transform_stream;
+        std::optional<StreamBuffer> m_commands;
+        std::vector<SceneMesh> m_meshes;
+        std::vector<std::uint32_t> m_mesh_order;   // meshes sorted by vao, mode and index type
+        bool m_mesh_order_dirty;                   // meshes were added since the last sort, done by Draw
+        std::vector<std::uint32_t> m_mesh_visible; // visible instances per mesh, counted by Cull
+        std::vector<std::uint32_t> m_mesh_first;   // first transform of each mesh in the stream range, set by Draw
+        std::vector<float> m_center_x;
+        std::vector<float> m_center_y;
+        std::vector<float> m_center_z;
+        std::vector<float> m_radius;
+        std::vector<glm::mat4> m_transforms;
+        std::vector<std::uint32_t> m_instance_mesh;
+        std::vector<std::uint8_t> m_visible;
+        glm::vec4 m_planes[6];
+        SceneStats m_stats;
+    };
+}
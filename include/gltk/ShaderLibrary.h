@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <gltk/AsyncProgramBuilder.h>
+#include <gltk/ProgramCache.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gltk
+{
+    struct ShaderFiles
+    {
+        std::filesystem::path vertex{};
+        std::filesystem::path geometry{}; // optional
+        std::filesystem::path fragment{};
+    };
+
+    struct ShaderLibraryStats
+    {
+        int builds;          // programs submitted to the builder, initial loads included
+        int swaps;           // builds that linked and replaced the previous program
+        int failures;        // builds that failed and left the previous program in place
+        int skipped;         // file changes and rebuilds dropped because the contents or expanded sources were unchanged
+        int file_events;
+    };
+
+    class ShaderProgram
+    {
+        friend class ShaderLibrary;
+    private:
+        struct State
+        {
+            std::string name;
+            ShaderFiles files;
+            GLuint program;
+            int generation;                                 // incremented every time program is replaced
+            std::string error;                              // last failed build, empty once a build succeeds
+            std::vector<std::filesystem::path> dependencies; // stage files and everything they include
+            std::uint64_t sources_hash;                     // of the expanded sources of program
+            std::uint64_t pending_hash;                     // of the expanded sources of pending
+            AsyncProgram pending;
+            bool dirty;                                     // changed again while a build was pending
+        };
+    private:
+        explicit ShaderProgram(std::shared_ptr<State> state) : m_state{ std::move(state) } {}
+    public:
+        ShaderProgram() = default;
+    public:
+        bool Valid() const noexcept { return m_state != nullptr; }
+        const std::string& Name() const noexcept { return m_state->name; }
+        // 0 until the first successful build, then always the last program that linked
+        GLuint Program() const noexcept { return m_state->program; }
+        int Generation() const noexcept { return m_state->generation; }
+        bool Building() const noexcept { return m_state->pending.Valid(); }
+        const std::string& Error() const noexcept { return m_state->error; }
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Builds programs from stage files on disk and rebuilds them when the files change. `#include "file"` directives
+    // are expanded recursively (relative to the including file, then to the library root), each file at most once
+    // per stage, with #line directives so that compiler errors point at the right file; the error of a failed build
+    // lists which source string number is which file.
+    // Changes are picked up with inotify on Linux and by polling modification times elsewhere. Only programs whose
+    // expanded sources actually changed are rebuilt, asynchronously, and a rebuilt program replaces the previous one
+    // only if it links. Update must be called on the thread owning the OpenGL context, typically once per frame.
+    class ShaderLibrary
+    {
+    public:
+        explicit ShaderLibrary(const std::filesystem::path& root, ProgramCache* cache = nullptr);
+        ~ShaderLibrary() noexcept;
+        ShaderLibrary(const ShaderLibrary&) = delete;
+        ShaderLibrary(ShaderLibrary&&) noexcept = delete;
+        ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+        ShaderLibrary& operator=(ShaderLibrary&&) noexcept = delete;
+    public:
+        const std::filesystem::path& Root() const noexcept { return m_root; }
+        bool Watching() const noexcept { return m_watch_fd >= 0; } // false when falling back to polling
+        const AsyncProgramBuilder& Builder() const noexcept { return m_builder; }
+        const ShaderLibraryStats& Stats() const noexcept { return m_stats; }
+    public:
+        // paths are relative to the library root
+        ShaderProgram Load(const std::string& name, const ShaderFiles& files);
+        int Update();
+    private:
+        void Build(ShaderProgram::State& state);
+        void Harvest(ShaderProgram::State& state);
+        bool Expand(const std::filesystem::path& file, std::string& out, std::vector<std::filesystem::path>& dependencies,
+            std::vector<std::filesystem::path>& included, std::string& error) const;
+        void Watch(const std::filesystem::path& file);
+        std::vector<std::filesystem::path> ChangedFiles();
+    private:
+        constexpr static std::chrono::milliseconds POLL_INTERVAL{ 500 };
+    private:
+        struct WatchedFile
+        {
+            std::uint64_t hash; // of the contents, to ignore saves that do not change anything
+            std::filesystem::file_time_type write_time;
+        };
+    private:
+        std::filesystem::path m_root;
+        AsyncProgramBuilder m_builder;
+        std::vector<std::shared_ptr<ShaderProgram::State>> m_programs;
+        std::unordered_map<std::string, WatchedFile> m_files;
+        int m_watch_fd;
+        std::unordered_map<int, std::filesystem::path> m_watch_dirs;
+        std::chrono::steady_clock::time_point m_last_poll;
+        ShaderLibraryStats m_stats;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+// Compile-time std140 layouts. A Std140Layout lists the GLSL member types of a uniform block in order and computes
+// their offsets with the std140 rules; the C++ struct mirroring the block is then checked against it member by
+// member, so that it can be copied to the buffer as is. The struct must be declared alignas(16), and a vec3
+// followed by a scalar needs alignas(16) on the vec3 so that the scalar packs into its fourth component:
+//
+//     struct alignas(16) Camera { glm::mat4 view_proj; alignas(16) glm::vec3 position; float exposure; };
+//     using CameraLayout = gltk::Std140Layout<glm::mat4, glm::vec3, float>;
+//     gltk_Std140Member(Camera, view_proj, CameraLayout, 0);
+//     gltk_Std140Member(Camera, position, CameraLayout, 1);
+//     gltk_Std140Member(Camera, exposure, CameraLayout, 2);
+//     gltk_Std140Block(Camera, CameraLayout);
+#define gltk_Std140Member(type, member, layout, idx) \
+    static_assert(std::is_same_v<decltype(type::member), std::tuple_element_t<idx, typename layout::Types>>, "std140: type of '" #type "::" #member "' does not match the layout"); \
+    static_assert(offsetof(type, member) == layout::OFFSETS[idx], "std140: offset of '" #type "::" #member "' does not match the layout")
+#define gltk_Std140Block(type, layout) \
+    static_assert(sizeof(type) == layout::SIZE, "std140: size of '" #type "' does not match the layout (missing alignas(16)?)"); \
+    static_assert(std::is_trivially_copyable_v<type>, "std140: '" #type "' must be trivially copyable")
+
+namespace gltk
+{
+    constexpr std::size_t Std140RoundUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // base alignment and size of a GLSL type in std140
+    template <typename T>
+    struct Std140Traits;
+
+    template <>
+    struct Std140Traits<float>
+    {
+        constexpr static std::size_t ALIGNMENT{ 4 };
+        constexpr static std::size_t SIZE{ 4 };
+    };
+    template <>
+    struct Std140Traits<std::int32_t>
+    {
+        constexpr static std::size_t ALIGNMENT{ 4 };
+        constexpr static std::size_t SIZE{ 4 };
+    };
+    template <>
+    struct Std140Traits<std::uint32_t> // also GLSL bool
+    {
+        constexpr static std::size_t ALIGNMENT{ 4 };
+        constexpr static std::size_t SIZE{ 4 };
+    };
+    template <glm::length_t L, typename T, glm::qualifier Q>
+    struct Std140Traits<glm::vec<L, T, Q>>
+    {
+        static_assert(sizeof(T) == 4 && L >= 2 && L <= 4);
+        constexpr static std::size_t ALIGNMENT{ (L == 2 ? 2 : 4) * sizeof(T) }; // vec3 aligns like vec4
+        constexpr static std::size_t SIZE{ L * sizeof(T) };
+    };
+    template <glm::qualifier Q>
+    struct Std140Traits<glm::mat<4, 4, float, Q>>
+    {
+        constexpr static std::size_t ALIGNMENT{ 16 };
+        constexpr static std::size_t SIZE{ 64 };
+    };
+
+    // array whose elements are padded to 16 bytes, as std140 requires for every array
+    template <typename T, std::size_t N>
+    struct Std140Array
+    {
+        struct alignas(16) Element
+        {
+            T value;
+        };
+
+        T& operator[](std::size_t i) noexcept { return elements[i].value; }
+        const T& operator[](std::size_t i) const noexcept { return elements[i].value; }
+
+        Element elements[N];
+    };
+    template <typename T, std::size_t N>
+    struct Std140Traits<Std140Array<T, N>>
+    {
+        constexpr static std::size_t ALIGNMENT{ 16 };
+        constexpr static std::size_t SIZE{ N * Std140RoundUp(Std140Traits<T>::SIZE, 16) };
+    };
+
+    // mat3 is stored as three vec4 columns in std140, unlike glm::mat3
+    struct Std140Mat3
+    {
+        Std140Mat3() = default;
+        Std140Mat3(const glm::mat3& m) : columns{ glm::vec4{ m[0], 0.0f }, glm::vec4{ m[1], 0.0f }, glm::vec4{ m[2], 0.0f } } {}
+        operator glm::mat3() const { return glm::mat3{ glm::vec3{ columns[0] }, glm::vec3{ columns[1] }, glm::vec3{ columns[2] } }; }
+
+        glm::vec4 columns[3];
+    };
+    template <>
+    struct Std140Traits<Std140Mat3>
+    {
+        constexpr static std::size_t ALIGNMENT{ 16 };
+        constexpr static std::size_t SIZE{ 48 };
+    };
+
+    template <typename... Ts>
+    struct Std140Layout
+    {
+        using Types = std::tuple<Ts...>;
+
+        constexpr static std::array<std::size_t, sizeof...(Ts)> OFFSETS{ []()
+        {
+            std::array<std::size_t, sizeof...(Ts)> offsets{};
+            std::size_t offset{};
+            std::size_t i{};
+            ((offset = Std140RoundUp(offset, Std140Traits<Ts>::ALIGNMENT), offsets[i++] = offset, offset += Std140Traits<Ts>::SIZE), ...);
+            return offsets;
+        }() };
+        constexpr static std::size_t SIZE{ Std140RoundUp(OFFSETS.back() + Std140Traits<std::tuple_element_t<sizeof...(Ts) - 1, Types>>::SIZE, 16) };
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+namespace gltk
+{
+    struct StreamRange
+    {
+        void* data;      // CPU write pointer, valid until Unmap
+        GLintptr offset; // offset of the range inside Buffer()
+        GLsizeiptr size;
+    };
+
+    struct StreamBufferStats
+    {
+        std::int64_t maps;
+        std::int64_t bytes;
+        std::int64_t fence_checks; // fences that had to be inspected before reusing their range
+        std::int64_t fence_waits;  // fences that were not signaled yet, so the CPU blocked on them
+        std::chrono::nanoseconds wait_time;
+    };
+
+    // Ring buffer for data rewritten every frame. Ranges are suballocated linearly and guarded by one fence per
+    // frame, so that the CPU only waits when it wraps around onto data the GPU has not consumed yet.
+    // With ARB_buffer_storage the buffer is mapped once (persistent, coherent), otherwise each range is mapped
+    // unsynchronized with an explicit flush.
+    class StreamBuffer
+    {
+    public:
+        StreamBuffer(GLenum target, GLsizeiptr capacity);
+        ~StreamBuffer() noexcept;
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer(StreamBuffer&&) noexcept = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(StreamBuffer&&) noexcept = delete;
+    public:
+        GLuint Buffer() const noexcept { return m_buffer; }
+        GLsizeiptr Capacity() const noexcept { return m_capacity; }
+        bool Persistent() const noexcept { return m_persistent != nullptr; }
+        const StreamBufferStats& Stats() const noexcept { return m_stats; }
+    public:
+        StreamRange Map(GLsizeiptr size, GLsizeiptr alignment = 16);
+        void Unmap(const StreamRange& range);
+        void EndFrame();
+    private:
+        void WaitForRange(std::uint64_t end);
+    private:
+        struct Fence
+        {
+            std::uint64_t begin; // monotonic position at which the fenced frame started writing
+            GLsync sync;
+        };
+    private:
+        GLenum m_target;
+        GLsizeiptr m_capacity;
+        GLuint m_buffer;
+        char* m_persistent;
+        std::uint64_t m_head;       // monotonic write position, the ring offset is m_head % m_capacity
+        std::uint64_t m_frame_begin;
+        std::deque<Fence> m_fences;
+        StreamBufferStats m_stats;
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <gltk/GltfLoader.h>
+#include <gltk/TextureLoader.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace gltk
+{
+    struct AtlasRect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    // Skyline bottom-left rectangle packer: the top edge of what was placed so far is kept as a list of horizontal
+    // segments, and each rectangle goes where its top ends up lowest.
+    class AtlasPacker
+    {
+    public:
+        AtlasPacker(int width, int height);
+        ~AtlasPacker() noexcept = default;
+        AtlasPacker(const AtlasPacker&) = delete;
+        AtlasPacker(AtlasPacker&&) noexcept = default;
+        AtlasPacker& operator=(const AtlasPacker&) = delete;
+        AtlasPacker& operator=(AtlasPacker&&) noexcept = default;
+    public:
+        int Width() const noexcept { return m_width; }
+        int Height() const noexcept { return m_height; }
+        float Occupancy() const noexcept { return static_cast<float>(m_used_area) / (static_cast<float>(m_width) * static_cast<float>(m_height)); }
+    public:
+        std::optional<AtlasRect> Insert(int width, int height); // nullopt if it does not fit
+        void Clear();
+    private:
+        int Fit(std::size_t idx, int width) const; // y at which a rectangle starting at segment idx would sit
+    private:
+        struct Segment
+        {
+            int x;
+            int y;
+            int width;
+        };
+    private:
+        int m_width;
+        int m_height;
+        std::int64_t m_used_area;
+        std::vector<Segment> m_skyline; // sorted by x, covering [0, width)
+    };
+
+    // What a material references instead of a texture name. A shader samples it with
+    // texture(array, vec3(rect.xy + uv * rect.zw, layer)).
+    struct TextureRegion
+    {
+        GLuint texture; // GL_TEXTURE_2D_ARRAY, 0 until the Build following its Add
+        int layer;
+        glm::vec4 rect; // offset (xy) and scale (zw) of the image within the layer, in uv units
+    };
+
+    struct TextureArraysStats
+    {
+        int images;
+        int atlased;                 // packed into shared atlas layers, the others have a layer of their own
+        int arrays;
+        int layers;
+        std::int64_t bytes;          // GPU memory of the arrays, mip levels included
+        std::int64_t separate_bytes; // what the images would take as individual textures with full mip chains
+        float atlas_occupancy;       // of the atlas layers, padding counted as unused
+    };
+
+    // Regroups RGBA8 images into few GL_TEXTURE_2D_ARRAY textures, small ones packed into padded atlas layers, so
+    // that materials share texture bindings. Images sampled with a repeating wrap mode must not be atlased.
+    class TextureArrays
+    {
+    public:
+        constexpr static int ATLAS_SIZE{ 2048 };
+        constexpr static int MIN_ATLAS_SIZE{ 256 };
+        constexpr static int MAX_ATLAS_IMAGE{ 256 };
+        constexpr static int ATLAS_LEVELS{ 3 };
+        constexpr static int PADDING{ 1 << (ATLAS_LEVELS - 1) }; // still one texel on the smallest atlas level
+    public:
+        TextureArrays();
+        ~TextureArrays() noexcept;
+        TextureArrays(const TextureArrays&) = delete;
+        TextureArrays(TextureArrays&&) noexcept = delete;
+        TextureArrays& operator=(const TextureArrays&) = delete;
+        TextureArrays& operator=(TextureArrays&&) noexcept = delete;
+    public:
+        int Count() const noexcept { return static_cast<int>(m_regions.size()); }
+        int Pending() const noexcept { return static_cast<int>(m_pending.size()); }
+        const TextureRegion& Region(int id) const noexcept { return m_regions[id]; }
+        const std::vector<GLuint>& Textures() const noexcept { return m_textures; }
+        const TextureArraysStats& Stats() const noexcept { return m_stats; }
+    public:
+        // return the id of the image's region
+        int Add(GLuint texture, bool atlas = true); // GL_TEXTURE_2D, RGBA8, its level 0 is copied by Build
+        int Add(const TextureAsset& texture, bool atlas = true); // a Ready asset
+        int Add(int width, int height, std::span<const unsigned char> rgba, bool atlas = true);
+        void Build(); // places everything added since the last Build into new arrays
+    private:
+        struct PendingImage
+        {
+            int region;
+            int width;
+            int height;
+            GLuint texture;
+            std::vector<unsigned char> pixels; // when texture is 0
+            bool atlas;
+        };
+    private:
+        GLuint CreateArray(int width, int height, int layers, int levels, GLint wrap);
+        void CopyImage(const PendingImage& image, GLuint array, int layer, int x, int y, int padding);
+    private:
+        GLuint m_read_fbo;
+        GLuint m_draw_fbo;
+        std::vector<TextureRegion> m_regions;
+        std::vector<PendingImage> m_pending;
+        std::vector<GLuint> m_textures;
+        std::int64_t m_atlas_area; // image texels in atlas layers
+        std::int64_t m_atlas_capacity; // texels of the atlas layers
+        TextureArraysStats m_stats;
+    };
+
+    // Adds the base color images of a Ready glTF asset and returns, per material, the region of its base color
+    // texture (-1 for none). An image only goes into the atlas when every primitive sampling it keeps its texture
+    // coordinates within [0, 1] (by the accessor bounds) or its sampler clamps, since atlas rects cannot repeat.
+    std::vector<int> AddGltfMaterials(TextureArrays& arrays, const GltfAsset& asset);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <gltk/MappedFile.h>
+#include <gltk/StreamBuffer.h>
+#include <gltk/ThreadPool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace gltk
+{
+    enum class TextureStage { Loading, Uploading, Ready, Failed };
+
+    struct TextureTimings
+    {
+        std::chrono::nanoseconds load;   // decode and mip generation, or cache mapping on a hit (worker thread)
+        std::chrono::nanoseconds wait;   // time spent waiting for the context thread to start the upload
+        std::chrono::nanoseconds upload; // staging copies and GL calls, summed over the Update calls that uploaded it
+        std::chrono::nanoseconds total;
+    };
+
+    struct TextureLoaderStats
+    {
+        int cache_hits;
+        int cache_misses;
+        int cache_writes;
+        std::int64_t bytes_uploaded;
+    };
+
+    class TextureAsset
+    {
+        friend class TextureLoader;
+    private:
+        struct State
+        {
+            std::filesystem::path path;
+            std::atomic<TextureStage> stage;
+            bool from_cache;
+            int width;
+            int height;
+            int levels;
+            std::chrono::steady_clock::time_point start_time;
+            std::chrono::steady_clock::time_point loaded_time;
+            TextureTimings timings;
+            std::string error;
+            std::unique_ptr<MappedFile> mapping; // cache hit: the levels are read straight from the mapping
+            std::vector<unsigned char> pixels;   // cache miss: the decoded levels
+            std::span<const unsigned char> levels_data; // all levels, RGBA8, tightly packed, largest first
+            GLuint texture;
+            int next_level; // upload progress, the context thread only
+            int next_row;
+        };
+    private:
+        explicit TextureAsset(std::shared_ptr<State> state) : m_state{ std::move(state) } {}
+    public:
+        TextureAsset() = default;
+    public:
+        bool Valid() const noexcept { return m_state != nullptr; }
+        const std::filesystem::path& Path() const noexcept { return m_state->path; }
+        TextureStage Stage() const noexcept { return m_state->stage.load(std::memory_order_acquire); }
+        // the accessors below are only meaningful once Stage() is Ready (or Failed for Error)
+        GLuint Texture() const noexcept { return m_state->texture; }
+        int Width() const noexcept { return m_state->width; }
+        int Height() const noexcept { return m_state->height; }
+        int Levels() const noexcept { return m_state->levels; }
+        bool FromCache() const noexcept { return m_state->from_cache; }
+        const TextureTimings& Timings() const noexcept { return m_state->timings; }
+        const std::string& Error() const noexcept { return m_state->error; }
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // Loads 2D RGBA8 textures with a full mip chain. Images are decoded and downsampled on a thread pool and the
+    // result is written to an on-disk cache, so later loads of the same unchanged file only map the cache entry.
+    // Only Update, which must be called on the thread owning the OpenGL context, touches GL: it copies levels into a
+    // pixel unpack stream buffer and issues the texture uploads from there, so the copies to the GPU are asynchronous.
+    // Uploads are spread over multiple Update calls according to their byte budget.
+    class TextureLoader
+    {
+    public:
+        TextureLoader(ThreadPool& pool, const std::filesystem::path& cache_dir, GLsizeiptr staging_capacity = 32 * 1024 * 1024);
+        ~TextureLoader() noexcept = default;
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader(TextureLoader&&) noexcept = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+        TextureLoader& operator=(TextureLoader&&) noexcept = delete;
+    public:
+        int Pending() const noexcept { return static_cast<int>(m_pending.size()); }
+        TextureLoaderStats Stats() const noexcept;
+    public:
+        TextureAsset Load(const std::filesystem::path& path);
+        int Update(GLsizeiptr max_bytes = 8 * 1024 * 1024);
+        void Unload(TextureAsset& asset);
+    private:
+        struct SharedStats
+        {
+            std::atomic<int> cache_hits;
+            std::atomic<int> cache_misses;
+            std::atomic<int> cache_writes;
+        };
+    private:
+        static void LoadLevels(const std::filesystem::path& cache_dir, SharedStats& stats, TextureAsset::State& state);
+        static bool LoadFromCache(const std::filesystem::path& entry_path, std::uint64_t key, TextureAsset::State& state);
+        static bool WriteToCache(const std::filesystem::path& entry_path, std::uint64_t key, const TextureAsset::State& state);
+        GLsizeiptr Upload(TextureAsset::State& state, GLsizeiptr budget);
+    private:
+        ThreadPool& m_pool;
+        std::filesystem::path m_cache_dir;
+        StreamBuffer m_staging;
+        std::vector<std::shared_ptr<TextureAsset::State>> m_pending;
+        std::shared_ptr<SharedStats> m_shared_stats; // outlives the loader for jobs still in the pool
+        std::int64_t m_bytes_uploaded;
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gltk
+{
+    // Fixed set of worker threads consuming a FIFO of jobs. Jobs still queued when the pool is destroyed are dropped.
+    class ThreadPool
+    {
+    public:
+        using Job = std::move_only_function<void()>;
+    public:
+        explicit ThreadPool(int thread_count = DefaultThreadCount());
+        ~ThreadPool() noexcept;
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+    public:
+        static int DefaultThreadCount();
+        int ThreadCount() const noexcept { return static_cast<int>(m_threads.size()); }
+    public:
+        void Submit(Job job);
+    private:
+        void Run(std::stop_token stop);
+    private:
+        std::mutex m_mutex;
+        std::condition_variable_any m_cv;
+        std::deque<Job> m_jobs;
+        std::vector<std::jthread> m_threads;
+    };
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <gltk/Std140.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <vector>
+
+namespace gltk
+{
+    struct UniformBufferStats
+    {
+        std::int64_t writes;
+        std::int64_t unchanged_writes; // writes that matched the shadow copy and did not dirty anything
+        std::int64_t upload_calls;     // glBufferSubData calls, one per merged dirty range
+        std::int64_t upload_bytes;
+    };
+
+    struct UniformBlockMember
+    {
+        std::string name;
+        GLint offset;
+    };
+
+    struct UniformBlockInfo
+    {
+        std::string name;
+        GLuint index;
+        GLint binding;
+        GLint size;
+        std::vector<UniformBlockMember> members;
+    };
+
+    // uniform blocks of a linked program, with their bindings and the offsets of their members
+    std::vector<UniformBlockInfo> ReflectUniformBlocks(GLuint program);
+    // assigns a binding point to a block (GLSL 330 has no layout(binding)), false if the program has no such block
+    bool BindUniformBlock(GLuint program, const char* block_name, GLuint binding);
+
+    // Uniform buffer object that tracks which byte ranges of its CPU shadow copy changed, and uploads only those
+    // ranges (merged when they are close) in Upload, meant to be called once per frame before drawing.
+    class UniformBuffer
+    {
+    public:
+        explicit UniformBuffer(GLsizeiptr size);
+        ~UniformBuffer() noexcept;
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer(UniformBuffer&&) noexcept = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(UniformBuffer&&) noexcept = delete;
+    public:
+        GLuint Buffer() const noexcept { return m_buffer; }
+        GLsizeiptr Size() const noexcept { return m_size; }
+        bool Dirty() const noexcept { return !m_dirty.empty(); }
+        const UniformBufferStats& Stats() const noexcept { return m_stats; }
+    public:
+        void Write(GLintptr offset, const void* data, GLsizeiptr size);
+        void Upload();
+        void BindBase(GLuint binding);
+    private:
+        void MarkDirty(GLintptr begin, GLintptr end);
+    private:
+        constexpr static GLintptr MERGE_GAP{ 64 }; // re-uploading a few clean bytes is cheaper than another call
+    private:
+        GLsizeiptr m_size;
+        GLuint m_buffer;
+        std::vector<unsigned char> m_shadow;
+        std::vector<std::pair<GLintptr, GLintptr>> m_dirty; // sorted, disjoint [begin, end) ranges
+        UniformBufferStats m_stats;
+    };
+
+    // UniformBuffer holding one std140 struct (see Std140.h), written member by member
+    template <typename T>
+    class UniformBlock : public UniformBuffer
+    {
+        static_assert(std::is_trivially_copyable_v<T> && alignof(T) >= 16, "uniform blocks must be alignas(16) std140 structs");
+    public:
+        UniformBlock() : UniformBuffer{ sizeof(T) } {}
+    public:
+        void Set(const T& value)
+        {
+            Write(0, &value, sizeof(T));
+        }
+        template <typename M>
+        void Set(M T::* member, const M& value)
+        {
+            static const T probe{}; // only used to turn the member pointer into an offset
+            GLintptr offset{ reinterpret_cast<const unsigned char*>(&(probe.*member)) - reinterpret_cast<const unsigned char*>(&probe) };
+            Write(offset, &value, sizeof(M));
+        }
+    };
+}
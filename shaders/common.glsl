@@ -0,0 +1,5 @@
+layout (std140) uniform Frame
+{
+    vec4 color;
+    float time;
+};
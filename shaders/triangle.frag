@@ -0,0 +1,7 @@
+#version 330 core
+#include "common.glsl"
+out vec4 FragColor;
+void main()
+{
+    FragColor = color * (0.75 + 0.25 * sin(time * 2.0));
+}
@@ -10,32 +10,93 @@
 
 #include <gltk/GLTK.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <format>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 constexpr const char* WINDOW_TITLE{ "gltk" };
 constexpr int WINDOW_W{ 1280 };
 constexpr int WINDOW_H{ 720 };
 constexpr const char* IMGUI_GLSL_VERSION{ "#version 130" };
+constexpr const char* PROGRAM_CACHE_DIR{ "gltk_cache/programs" };
+constexpr const char* TEXTURE_CACHE_DIR{ "gltk_cache/textures" };
+constexpr GLsizeiptr STREAM_BUFFER_SIZE{ 4 * 1024 * 1024 };
+constexpr GLuint FRAME_UNIFORMS_BINDING{ 0 };
 
-// TODO: load these from files
-constexpr const char* VERTEX_SHADER_SOURCE{
-    "#version 330 core\n"
-    "layout (location = 0) in vec3 aPos;\n"
-    "void main()\n"
-    "{\n"
-    "   gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);\n"
-    "}\0"
+// mirrors the Frame block of shaders/common.glsl
+struct alignas(16) FrameUniforms
+{
+    glm::vec4 color;
+    float time;
+};
+using FrameUniformsLayout = gltk::Std140Layout<glm::vec4, float>;
+gltk_Std140Member(FrameUniforms, color, FrameUniformsLayout, 0);
+gltk_Std140Member(FrameUniforms, time, FrameUniformsLayout, 1);
+gltk_Std140Block(FrameUniforms, FrameUniformsLayout);
+
+// what a frame changes, computed on the main thread and handed to the render thread by value
+struct FrameUpdate
+{
+    float time;
+    glm::vec3 triangle[3]; // spinning triangle, rewritten into the stream buffer every frame
+};
+
+static FrameUpdate UpdateFrame(float time)
+{
+    FrameUpdate update{};
+    update.time = time;
+    for (int i{}; i < 3; i++)
+    {
+        float a{ time + static_cast<float>(i) * 2.0943951f };
+        update.triangle[i] = glm::vec3{ 0.5f * glm::cos(a), 0.5f * glm::sin(a), 0.0f };
+    }
+    return update;
+}
+
+// preprocessed mesh file (see gltk_mesh_tool), mapped and uploaded as is
+struct LoadedMesh
+{
+    std::filesystem::path path;
+    std::size_t file_size;
+    std::uint32_t vertices;
+    std::chrono::nanoseconds load_time;
+    std::unique_ptr<gltk::GpuMesh> mesh;
 };
-constexpr const char* FRAGMENT_SHADER_SOURCE{
-    "#version 330 core\n"
-    "out vec4 FragColor;\n"
-    "void main()\n"
-    "{\n"
-    "   FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);\n"
-    "}\n\0"
+
+// imgui draw lists copied out of the context, so that the next frame can be built while this one is rendered
+struct ImGuiDrawSnapshot
+{
+    ImDrawData data;
+    std::vector<std::unique_ptr<ImDrawList, void(*)(ImDrawList*)>> lists;
 };
 
+static std::shared_ptr<ImGuiDrawSnapshot> SnapshotImGuiDrawData(const ImDrawData& draw_data)
+{
+    auto snapshot{ std::make_shared<ImGuiDrawSnapshot>() };
+    snapshot->data = draw_data;
+    for (int i{}; i < draw_data.CmdLists.Size; i++)
+    {
+        snapshot->lists.emplace_back(draw_data.CmdLists[i]->CloneOutput(), [](ImDrawList* list) { IM_DELETE(list); });
+        snapshot->data.CmdLists[i] = snapshot->lists.back().get();
+    }
+    return snapshot;
+}
+
+// for labels that only live for the frame
+static std::pmr::string FileName(const std::filesystem::path& path, std::pmr::memory_resource* memory)
+{
+    return path.filename().string<char, std::char_traits<char>, std::pmr::polymorphic_allocator<char>>(memory);
+}
+
 static void OnGLFWError(int error, const char* description)
 {
     std::cerr << std::format("[GLFW({})]: {}\n", error, description);
@@ -84,8 +145,35 @@ static void GLAPIENTRY OnOpenGLDebugMessage(GLenum source, GLenum type, GLuint i
     std::cerr << std::format("[GL({})]:{}:{}:{}: {}\n", id, source_str, type_str, severity_str, message);
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --headless renders offscreen in a hidden window with vsync off, --frames N exits after N frames,
+    // --threaded runs the update on the main thread and replays its GL commands on a render thread
+    bool headless{};
+    bool threaded{};
+    int max_frames{};
+    std::vector<std::filesystem::path> asset_paths{};
+    for (int i{ 1 }; i < argc; i++)
+    {
+        std::string_view arg{ argv[i] };
+        if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg == "--threaded")
+        {
+            threaded = true;
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            max_frames = std::atoi(argv[++i]);
+        }
+        else
+        {
+            asset_paths.push_back(argv[i]);
+        }
+    }
+
     try
     {
         glfwSetErrorCallback(OnGLFWError);
@@ -96,6 +184,7 @@ int main()
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, !headless);
         #if !defined(NDEBUG)
         glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
         #endif
@@ -146,7 +235,17 @@ int main()
         #endif
 
         // configure context
-        glfwSwapInterval(1); // enable vsync
+        glfwSwapInterval(headless ? 0 : 1); // vsync only when presenting
+
+        // a hidden window's default framebuffer may not be backed by anything, so headless runs draw into an FBO
+        std::optional<gltk::RenderTarget> offscreen_target{};
+        if (headless)
+        {
+            offscreen_target.emplace(WINDOW_W, WINDOW_H);
+        }
+
+        // frame profiler, gltk_ProfileZone records into it
+        gltk::Profiler profiler{};
 
         // create imgui context
         IMGUI_CHECKVERSION();
@@ -163,70 +262,489 @@ int main()
         auto shutdown_imgui_opengl_impl_on_exit{ sg::make_scope_guard([]() { ImGui_ImplOpenGL3_Shutdown(); }) };
 
         // build shaders
-        gltk::ProgramBuilder program_builder{};
-        if (!program_builder.Compile(GL_VERTEX_SHADER, VERTEX_SHADER_SOURCE))
-        {
-            std::cerr << std::format("[GLTK]: {}\n", program_builder.InfoLog());
-        }
-        if (!program_builder.Compile(GL_FRAGMENT_SHADER, FRAGMENT_SHADER_SOURCE))
-        {
-            std::cerr << std::format("[GLTK]: {}\n", program_builder.InfoLog());
-        }
-        GLuint shader_program{ program_builder.Link() };
-        if (!shader_program)
+        gltk::ProgramCache program_cache{ PROGRAM_CACHE_DIR };
+        gltk::ShaderLibrary shader_library{ GLTK_SHADER_DIR, &program_cache };
+        gltk::ShaderProgram triangle_shader{ shader_library.Load("triangle", { .vertex = "triangle.vert", .fragment = "triangle.frag" }) };
+        int triangle_shader_generation{};
+
+        // per-frame uniforms, uploaded once per frame and only where they changed
+        gltk::UniformBlock<FrameUniforms> frame_uniforms{};
+        frame_uniforms.Set(&FrameUniforms::color, glm::vec4{ 1.0f, 0.5f, 0.2f, 1.0f });
+
+        // load the glTF assets and images given on the command line
+        gltk::ThreadPool thread_pool{};
+        gltk::GltfLoader gltf_loader{ thread_pool };
+        gltk::TextureLoader texture_loader{ thread_pool, TEXTURE_CACHE_DIR };
+        std::vector<gltk::GltfAsset> assets{};
+        std::vector<gltk::TextureAsset> textures{};
+        std::vector<LoadedMesh> meshes{};
+        for (const std::filesystem::path& path : asset_paths)
         {
-            std::cerr << std::format("[GLTK]: {}\n", program_builder.InfoLog());
+            if (path.extension() == ".gltf" || path.extension() == ".glb")
+            {
+                assets.push_back(gltf_loader.Load(path));
+            }
+            else if (path.extension() == ".gltkmesh")
+            {
+                auto start{ std::chrono::steady_clock::now() };
+                gltk::MeshFile file{ path };
+                if (!file.Valid())
+                {
+                    std::cerr << std::format("[GLTK]: '{}' is not a valid mesh file\n", path.string());
+                    continue;
+                }
+                auto mesh{ std::make_unique<gltk::GpuMesh>(file) };
+                meshes.push_back({ path, file.Size(), file.Header().vertex_count, std::chrono::steady_clock::now() - start, std::move(mesh) });
+            }
+            else
+            {
+                textures.push_back(texture_loader.Load(path));
+            }
         }
 
-        while (!glfwWindowShouldClose(window))
+        // per-frame vertex data
+        gltk::StreamBuffer vertex_stream{ GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE };
+        GLuint vao{};
+        gltk_GLCheck(glGenVertexArrays(1, &vao));
+        auto delete_vao_on_exit{ sg::make_scope_guard([=]() { glDeleteVertexArrays(1, &vao); }) };
+        gltk_GLCheck(glBindVertexArray(vao));
+        gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, vertex_stream.Buffer()));
+        gltk_GLCheck(glEnableVertexAttribArray(0));
+        gltk_GLCheck(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr));
+        gltk_GLCheck(glBindVertexArray(0));
+
+        // draw submission
+        gltk::RenderQueue render_queue{};
+
+        // the loaded images regrouped into few array textures, once all of them are done loading
+        gltk::TextureArrays texture_arrays{};
+        bool texture_arrays_built{};
+
+        // per-frame CPU allocations, released at the beginning of every frame
+        gltk::FrameArena frame_arena{};
+        gltk::FramePool frame_pool{};
+
+        // present intervals and input to present latency
+        gltk::FramePacing frame_pacing{};
+
+        // lists recorded by the update thread and replayed by the render thread, when threaded
+        gltk::CommandQueue command_queue{};
+
+        // GL work that does not depend on the frame's update: shader builds, uploads and texture arrays, on the
+        // thread owning the context
+        auto prepare_frame{ [&]()
         {
-            // poll input events
-            glfwPollEvents();
+            profiler.BeginFrame();
+            frame_arena.Reset();
 
-            // process input
+            // advance shader builds and pick up edited shader files without stalling the frame
             {
-                if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                gltk_ProfileZone("Build Programs");
+                std::pmr::string previous_error{ triangle_shader.Error(), &frame_arena };
+                shader_library.Update();
+                if (!triangle_shader.Error().empty() && std::string_view{ triangle_shader.Error() } != previous_error)
                 {
-                    glfwSetWindowShouldClose(window, true);
+                    std::cerr << std::format("[GLTK]: {}\n", triangle_shader.Error());
+                }
+
+                // every new program starts with its blocks on binding 0, reassign them
+                if (triangle_shader.Generation() != triangle_shader_generation)
+                {
+                    triangle_shader_generation = triangle_shader.Generation();
+                    gltk::BindUniformBlock(triangle_shader.Program(), "Frame", FRAME_UNIFORMS_BINDING);
+                }
+            }
+
+            // finish asset loads on the context thread
+            {
+                gltk_ProfileZone("Upload Assets");
+                gltf_loader.Update();
+                texture_loader.Update();
+            }
+
+            // regroup the images into texture arrays once every load has finished
+            if (!texture_arrays_built)
+            {
+                bool loading{};
+                for (const gltk::GltfAsset& asset : assets)
+                {
+                    loading = loading || (asset.Stage() != gltk::AssetStage::Ready && asset.Stage() != gltk::AssetStage::Failed);
+                }
+                for (const gltk::TextureAsset& texture : textures)
+                {
+                    loading = loading || (texture.Stage() != gltk::TextureStage::Ready && texture.Stage() != gltk::TextureStage::Failed);
+                }
+                if (!loading)
+                {
+                    gltk_ProfileZone("Build Texture Arrays");
+                    for (const gltk::TextureAsset& texture : textures)
+                    {
+                        if (texture.Stage() == gltk::TextureStage::Ready)
+                        {
+                            texture_arrays.Add(texture);
+                        }
+                    }
+                    for (const gltk::GltfAsset& asset : assets)
+                    {
+                        if (asset.Stage() == gltk::AssetStage::Ready)
+                        {
+                            gltk::AddGltfMaterials(texture_arrays, asset);
+                        }
+                    }
+                    texture_arrays.Build();
+                    texture_arrays_built = true;
                 }
             }
+        } };
 
+        // replays a frame's update on the thread owning the context; the window state it needs is sampled by the
+        // main thread and passed in
+        auto render_frame{ [&](const FrameUpdate& update, int framebuffer_w, int framebuffer_h)
+        {
             // update viewport
+            if (offscreen_target)
             {
-                int w{};
-                int h{};
-                glfwGetFramebufferSize(window, &w, &h);
-                gltk_GLCheck(glViewport(0, 0, w, h));
+                offscreen_target->Bind();
+            }
+            else
+            {
+                gltk_GLCheck(glViewport(0, 0, framebuffer_w, framebuffer_h));
             }
 
             // render scene
             {
+                gltk_ProfileZone("Render Scene");
+
                 // clear
                 gltk_GLCheck(glClearColor(0.2f, 0.3f, 0.3f, 1.0f));
                 gltk_GLCheck(glClear(GL_COLOR_BUFFER_BIT));
+
+                // uniforms
+                frame_uniforms.Set(&FrameUniforms::time, update.time);
+                frame_uniforms.Upload();
+                frame_uniforms.BindBase(FRAME_UNIFORMS_BINDING);
+
+                // spinning triangle, rewritten every frame
+                if (GLuint shader_program{ triangle_shader.Program() })
+                {
+                    gltk::StreamRange range{ vertex_stream.Map(sizeof(update.triangle), sizeof(glm::vec3)) };
+                    std::memcpy(range.data, update.triangle, sizeof(update.triangle));
+                    vertex_stream.Unmap(range);
+
+                    render_queue.Submit({
+                        .program = shader_program,
+                        .vao = vao,
+                        .count = 3,
+                        .first = range.offset / static_cast<GLintptr>(sizeof(glm::vec3)),
+                    });
+                }
+
+                render_queue.Flush();
             }
+        } };
 
-            // imgui
+        // ends the frame started by render_frame, on the same thread
+        auto present{ [&]()
+        {
+            profiler.EndFrame();
+
+            // catch errors from calls that gltk_GLCheck did not check (imgui, deferred policy)
+            gltk_GLCheckpoint();
+
+            vertex_stream.EndFrame();
+            glfwSwapBuffers(window);
+        } };
+
+        // imgui logic, on the main thread
+        auto draw_gltk_window{ [&]()
+        {
+            ImGui::Begin("gltk");
+            if (ImGui::CollapsingHeader("Frame Pacing"))
             {
-                // start frame
-                ImGui_ImplOpenGL3_NewFrame();
-                ImGui_ImplGlfw_NewFrame();
-                ImGui::NewFrame();
+                const gltk::FramePacingStats stats{ frame_pacing.Stats() };
+                ImGui::Text("mode: %s, frames: %lld", threaded ? "threaded" : "single thread", static_cast<long long>(stats.frames));
+                ImGui::Text("interval: %.2f ms (stddev %.2f ms, p99 %.2f ms)", stats.interval_mean_ms, stats.interval_stddev_ms, stats.interval_p99_ms);
+                ImGui::Text("input to present: %.2f ms (p99 %.2f ms)", stats.latency_mean_ms, stats.latency_p99_ms);
+                if (threaded)
+                {
+                    const gltk::CommandQueueStats queue{ command_queue.Stats() };
+                    ImGui::Text("lists: %lld, update blocked: %.1f ms, render idle: %.1f ms", static_cast<long long>(queue.published),
+                        std::chrono::duration<double, std::milli>(queue.record_wait).count(), std::chrono::duration<double, std::milli>(queue.replay_wait).count());
+                }
+            }
+
+            // the other panels read objects that belong to the render thread when threaded
+            if (threaded)
+            {
+                ImGui::End();
+                return;
+            }
+
+            if (ImGui::CollapsingHeader("Profiler"))
+            {
+                profiler.DrawImGui();
+            }
+            if (ImGui::CollapsingHeader("Program Cache"))
+            {
+                const gltk::ProgramCacheStats& stats{ program_cache.Stats() };
+                ImGui::Text("enabled: %s", program_cache.Enabled() ? "yes" : "no");
+                ImGui::Text("hits: %d, misses: %d, rejects: %d, writes: %d", stats.hits, stats.misses, stats.rejects, stats.writes);
+                ImGui::Text("time saved: %.3f ms", std::chrono::duration<double, std::milli>(stats.time_saved).count());
+            }
+            if (ImGui::CollapsingHeader("Program Builder"))
+            {
+                ImGui::Text("parallel compile: %s", shader_library.Builder().Parallel() ? "yes" : "no");
+                ImGui::Text("pending: %d", shader_library.Builder().Pending());
+            }
+            if (ImGui::CollapsingHeader("Shaders"))
+            {
+                const gltk::ShaderLibraryStats& stats{ shader_library.Stats() };
+                ImGui::Text("root: %s (%s)", shader_library.Root().string().c_str(), shader_library.Watching() ? "inotify" : "polling");
+                ImGui::Text("builds: %d, swaps: %d, failures: %d, skipped: %d, file events: %d", stats.builds, stats.swaps, stats.failures, stats.skipped, stats.file_events);
+                ImGui::Text("%s: generation %d%s", triangle_shader.Name().c_str(), triangle_shader.Generation(), triangle_shader.Building() ? ", building" : "");
+                if (!triangle_shader.Error().empty())
+                {
+                    ImGui::TextWrapped("%s", triangle_shader.Error().c_str());
+                }
+            }
+            if (ImGui::CollapsingHeader("Uniforms"))
+            {
+                const gltk::UniformBufferStats& stats{ frame_uniforms.Stats() };
+                ImGui::Text("writes: %lld (unchanged: %lld)", static_cast<long long>(stats.writes), static_cast<long long>(stats.unchanged_writes));
+                ImGui::Text("upload calls: %lld, bytes: %lld", static_cast<long long>(stats.upload_calls), static_cast<long long>(stats.upload_bytes));
+                if (GLuint program{ triangle_shader.Program() })
+                {
+                    for (const gltk::UniformBlockInfo& block : gltk::ReflectUniformBlocks(program))
+                    {
+                        ImGui::Text("%s: binding %d, %d bytes", block.name.c_str(), block.binding, block.size);
+                        for (const gltk::UniformBlockMember& member : block.members)
+                        {
+                            ImGui::Text("  %s @ %d", member.name.c_str(), member.offset);
+                        }
+                    }
+                }
+            }
+            if (ImGui::CollapsingHeader("Frame Memory"))
+            {
+                auto show{ [](const char* name, const gltk::FrameMemoryStats& stats, std::size_t high_water, std::size_t reserved)
+                {
+                    ImGui::Text("%s: %lld allocations (%lld upstream), %lld deallocations, %.1f KiB requested", name,
+                        static_cast<long long>(stats.allocations), static_cast<long long>(stats.upstream_allocations),
+                        static_cast<long long>(stats.deallocations), static_cast<double>(stats.bytes) / 1024.0);
+                    ImGui::Text("  peak: %.1f KiB, high-water: %.1f KiB, reserved: %.1f KiB", static_cast<double>(stats.peak) / 1024.0,
+                        static_cast<double>(high_water) / 1024.0, static_cast<double>(reserved) / 1024.0);
+                } };
+                show("arena", frame_arena.LastFrame(), frame_arena.HighWater(), frame_arena.Capacity());
+                show("pool", frame_pool.LastFrame(), frame_pool.HighWater(), frame_pool.Reserved());
+            }
+            if (ImGui::CollapsingHeader("Stream Buffer"))
+            {
+                const gltk::StreamBufferStats& stats{ vertex_stream.Stats() };
+                ImGui::Text("persistent: %s", vertex_stream.Persistent() ? "yes" : "no");
+                ImGui::Text("maps: %lld, bytes: %lld", static_cast<long long>(stats.maps), static_cast<long long>(stats.bytes));
+                ImGui::Text("fence checks: %lld, fence waits: %lld (%.3f ms)", static_cast<long long>(stats.fence_checks),
+                    static_cast<long long>(stats.fence_waits), std::chrono::duration<double, std::milli>(stats.wait_time).count());
+            }
+            if (ImGui::CollapsingHeader("Render Queue"))
+            {
+                const gltk::RenderQueueStats& stats{ render_queue.Stats() };
+                ImGui::Text("items: %d, draw calls: %d (instanced: %d, multi: %d)", stats.items, stats.draw_calls, stats.instanced_draws, stats.multi_draws);
+                ImGui::Text("state changes: %lld, binds avoided: %lld", static_cast<long long>(stats.state_changes), static_cast<long long>(stats.binds_avoided));
+                ImGui::Text("texture binds: %lld", static_cast<long long>(stats.texture_binds));
+            }
+            if (ImGui::CollapsingHeader("Texture Arrays"))
+            {
+                const gltk::TextureArraysStats& stats{ texture_arrays.Stats() };
+                auto mib{ [](std::int64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); } };
+                ImGui::Text("images: %d (atlased: %d), arrays: %d, layers: %d", stats.images, stats.atlased, stats.arrays, stats.layers);
+                ImGui::Text("memory: %.1f MiB (as separate textures: %.1f MiB), atlas occupancy: %.0f%%",
+                    mib(stats.bytes), mib(stats.separate_bytes), 100.0 * stats.atlas_occupancy);
+                ImGui::Text("bindings to reach every image: %d instead of %d", stats.arrays, stats.images);
+            }
+            if (ImGui::CollapsingHeader("Assets"))
+            {
+                constexpr const char* STAGE_NAME[]{ "parsing", "decoding", "uploading", "ready", "failed" };
+                auto ms{ [](std::chrono::nanoseconds t) { return std::chrono::duration<double, std::milli>(t).count(); } };
+                for (const gltk::GltfAsset& asset : assets)
+                {
+                    gltk::AssetStage stage{ asset.Stage() };
+                    ImGui::ProgressBar(asset.Progress(), ImVec2{ 120.0f, 0.0f }, STAGE_NAME[static_cast<int>(stage)]);
+                    ImGui::SameLine();
+                    ImGui::TextUnformatted(FileName(asset.Path(), &frame_pool).c_str());
+                    if (stage == gltk::AssetStage::Ready)
+                    {
+                        const gltk::AssetTimings& t{ asset.Timings() };
+                        ImGui::Text("  parse %.1f ms, decode %.1f ms (cpu %.1f ms), wait %.1f ms, upload %.1f ms, total %.1f ms",
+                            ms(t.parse), ms(t.decode), ms(t.decode_cpu), ms(t.wait), ms(t.upload), ms(t.total));
+                    }
+                    else if (stage == gltk::AssetStage::Failed)
+                    {
+                        ImGui::Text("  %s", asset.Error().c_str());
+                    }
+                }
+            }
+            if (ImGui::CollapsingHeader("Meshes"))
+            {
+                for (const LoadedMesh& mesh : meshes)
+                {
+                    ImGui::Text("%s: %u vertices, %d triangles, %.1f KiB, loaded in %.2f ms", FileName(mesh.path, &frame_pool).c_str(),
+                        mesh.vertices, mesh.mesh->Count() / 3, static_cast<double>(mesh.file_size) / 1024.0,
+                        std::chrono::duration<double, std::milli>(mesh.load_time).count());
+                }
+            }
+            if (ImGui::CollapsingHeader("Textures"))
+            {
+                const gltk::TextureLoaderStats stats{ texture_loader.Stats() };
+                ImGui::Text("cache hits: %d, misses: %d, writes: %d", stats.cache_hits, stats.cache_misses, stats.cache_writes);
+                ImGui::Text("uploaded: %.1f MiB", static_cast<double>(stats.bytes_uploaded) / (1024.0 * 1024.0));
+                constexpr const char* STAGE_NAME[]{ "loading", "uploading", "ready", "failed" };
+                auto ms{ [](std::chrono::nanoseconds t) { return std::chrono::duration<double, std::milli>(t).count(); } };
+                for (const gltk::TextureAsset& texture : textures)
+                {
+                    gltk::TextureStage stage{ texture.Stage() };
+                    ImGui::Text("%s: %s", FileName(texture.Path(), &frame_pool).c_str(), STAGE_NAME[static_cast<int>(stage)]);
+                    if (stage == gltk::TextureStage::Ready)
+                    {
+                        const gltk::TextureTimings& t{ texture.Timings() };
+                        ImGui::Text("  %dx%d, %d levels, %s: load %.1f ms, wait %.1f ms, upload %.1f ms, total %.1f ms",
+                            texture.Width(), texture.Height(), texture.Levels(), texture.FromCache() ? "cached" : "decoded",
+                            ms(t.load), ms(t.wait), ms(t.upload), ms(t.total));
+                        ImGui::Image(static_cast<ImTextureID>(texture.Texture()), ImVec2{ 128.0f, 128.0f });
+                    }
+                    else if (stage == gltk::TextureStage::Failed)
+                    {
+                        ImGui::Text("  %s", texture.Error().c_str());
+                    }
+                }
+            }
+            ImGui::End();
+        } };
 
-                // imgui logic
+        if (!threaded)
+        {
+            for (int frame{}; !glfwWindowShouldClose(window) && (max_frames <= 0 || frame < max_frames); frame++)
+            {
+                frame_pool.Reset();
+
+                // poll input events
+                glfwPollEvents();
+                auto input_time{ std::chrono::steady_clock::now() };
+
+                // process input
                 {
+                    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                    {
+                        glfwSetWindowShouldClose(window, true);
+                    }
                 }
 
-                // render
-                ImGui::Render();
-                ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+                int w{};
+                int h{};
+                glfwGetFramebufferSize(window, &w, &h);
+                FrameUpdate update{ UpdateFrame(static_cast<float>(glfwGetTime())) };
+                prepare_frame();
+                render_frame(update, w, h);
+
+                // imgui
+                {
+                    gltk_ProfileZone("ImGui");
+                    ImGui_ImplOpenGL3_NewFrame();
+                    ImGui_ImplGlfw_NewFrame();
+                    ImGui::NewFrame();
+                    draw_gltk_window();
+                    ImGui::Render();
+                    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+                }
+
+                present();
+                frame_pacing.Present(input_time);
             }
+        }
+        else
+        {
+            // imgui creates its GL objects on the first frame, do that here while the context is still current
+            ImGui_ImplOpenGL3_NewFrame();
+
+            // from here on the context belongs to the render thread, which replays what the main thread records
+            glfwMakeContextCurrent(nullptr);
+            std::thread render_thread{ [&]()
+            {
+                glfwMakeContextCurrent(window);
+                auto release_context_on_exit{ sg::make_scope_guard([]() { glfwMakeContextCurrent(nullptr); }) };
+                try
+                {
+                    while (gltk::CommandList* commands{ command_queue.BeginReplay() })
+                    {
+                        auto input_time{ commands->InputTime() };
+                        commands->Execute();
+                        command_queue.EndReplay();
 
-            // present
+                        present();
+                        frame_pacing.Present(input_time);
+                    }
+                }
+                catch (const gltk::Crash& e)
+                {
+                    std::cerr << e.What() << '\n';
+                    glfwSetWindowShouldClose(window, true);
+                    command_queue.Close();
+                }
+            } };
+            auto stop_render_thread_on_exit{ sg::make_scope_guard([&]()
+            {
+                command_queue.Close();
+                render_thread.join();
+                glfwMakeContextCurrent(window);
+            }) };
+
+            for (int frame{}; !glfwWindowShouldClose(window) && (max_frames <= 0 || frame < max_frames); frame++)
             {
-                glfwSwapBuffers(window);
+                frame_pool.Reset();
+
+                // poll input events
+                glfwPollEvents();
+                auto input_time{ std::chrono::steady_clock::now() };
+
+                // process input
+                {
+                    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                    {
+                        glfwSetWindowShouldClose(window, true);
+                    }
+                }
+
+                // update, the render thread only sees what is captured by value here
+                FrameUpdate update{ UpdateFrame(static_cast<float>(glfwGetTime())) };
+                int w{};
+                int h{};
+                glfwGetFramebufferSize(window, &w, &h);
+                ImGui_ImplGlfw_NewFrame();
+                ImGui::NewFrame();
+                draw_gltk_window();
+                ImGui::Render();
+                std::shared_ptr<ImGuiDrawSnapshot> imgui_draw{ SnapshotImGuiDrawData(*ImGui::GetDrawData()) };
+
+                // record, waits while the render thread is still replaying the list recorded two frames ago
+                gltk::CommandList* commands{ command_queue.BeginRecord() };
+                if (!commands)
+                {
+                    break;
+                }
+                commands->Stamp(static_cast<std::uint64_t>(frame), input_time);
+                commands->Record([&prepare_frame]() { prepare_frame(); });
+                commands->Record([&render_frame, update, w, h]() { render_frame(update, w, h); });
+                commands->Record([imgui_draw]()
+                {
+                    gltk_ProfileZone("ImGui");
+                    ImGui_ImplOpenGL3_RenderDrawData(&imgui_draw->data);
+                });
+                command_queue.EndRecord();
             }
         }
+
+        const gltk::FramePacingStats stats{ frame_pacing.Stats() };
+        std::cerr << std::format("[GLTK]: {} frames, interval {:.2f} ms (stddev {:.2f} ms, p99 {:.2f} ms), input to present {:.2f} ms (p99 {:.2f} ms)\n",
+            stats.frames, stats.interval_mean_ms, stats.interval_stddev_ms, stats.interval_p99_ms, stats.latency_mean_ms, stats.latency_p99_ms);
     }
     catch (const gltk::Crash& e)
     {
@@ -0,0 +1,208 @@
+#include <gltk/AsyncProgramBuilder.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <format>
+
+namespace gltk
+{
+    constexpr GLenum STAGE_TYPE[]{ GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+    constexpr const char* STAGE_NAME[]{ "vertex", "geometry", "fragment" };
+
+    AsyncProgramBuilder::AsyncProgramBuilder(ProgramCache* cache, int max_blocking_steps_per_poll)
+        : m_cache{ cache }
+        , m_parallel{ GLAD_GL_KHR_parallel_shader_compile != 0 }
+        , m_max_blocking_steps_per_poll{ max_blocking_steps_per_poll }
+        , m_pending{}
+    {
+        gltk_Check(m_max_blocking_steps_per_poll > 0);
+        if (m_parallel)
+        {
+            // let the driver pick as many compiler threads as it sees fit
+            gltk_GLCheck(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+        }
+    }
+    AsyncProgramBuilder::~AsyncProgramBuilder()
+    {
+        for (const std::shared_ptr<AsyncProgram::State>& state : m_pending)
+        {
+            DeleteShaders(*state);
+            if (state->program)
+            {
+                gltk_GLCheck(glDeleteProgram(state->program));
+                state->program = 0;
+            }
+            state->status = AsyncProgram::Status::Failed;
+            state->info_log = "cancelled";
+        }
+    }
+    AsyncProgram AsyncProgramBuilder::Submit(const ProgramSources& sources)
+    {
+        auto state{ std::make_shared<AsyncProgram::State>() };
+        state->status = AsyncProgram::Status::Compiling;
+
+        const std::string stage_sources[]{ sources.vertex, sources.geometry, sources.fragment };
+        if (m_cache && m_cache->Enabled())
+        {
+            state->key = m_cache->Key(stage_sources);
+            if (GLuint program{ m_cache->Load(state->key) })
+            {
+                state->status = AsyncProgram::Status::Succeeded;
+                state->program = program;
+                return AsyncProgram{ state };
+            }
+        }
+
+        auto start{ std::chrono::steady_clock::now() };
+        for (int i{}; i < 3; i++)
+        {
+            if (!stage_sources[i].empty())
+            {
+                const GLchar* src{ stage_sources[i].c_str() };
+                GLint src_length{ static_cast<GLint>(stage_sources[i].size()) };
+                gltk_GLCheck(state->shader[i] = glCreateShader(STAGE_TYPE[i]));
+                gltk_GLCheck(glShaderSource(state->shader[i], 1, &src, &src_length));
+                gltk_GLCheck(glCompileShader(state->shader[i]));
+            }
+        }
+        state->build_time = std::chrono::steady_clock::now() - start;
+
+        m_pending.push_back(state);
+        return AsyncProgram{ state };
+    }
+    int AsyncProgramBuilder::Poll()
+    {
+        int blocking_steps{};
+        for (auto it{ m_pending.begin() }; it != m_pending.end();)
+        {
+            AsyncProgram::State& state{ **it };
+            if (m_parallel)
+            {
+                if (!IsComplete(state))
+                {
+                    ++it;
+                    continue;
+                }
+            }
+            else
+            {
+                if (blocking_steps >= m_max_blocking_steps_per_poll)
+                {
+                    break;
+                }
+                blocking_steps++;
+            }
+
+            // only the steps themselves count as build time, a job may wait several polls between them
+            auto start{ std::chrono::steady_clock::now() };
+            switch (state.status)
+            {
+            case AsyncProgram::Status::Compiling: { FinishCompile(state); } break;
+            case AsyncProgram::Status::Linking: { FinishLink(state); } break;
+            default: { gltk_Unreachable(); } break;
+            }
+            state.build_time += std::chrono::steady_clock::now() - start;
+
+            if (state.status == AsyncProgram::Status::Succeeded && m_cache && m_cache->Enabled())
+            {
+                m_cache->Store(state.key, state.program, state.build_time);
+            }
+
+            if (state.status == AsyncProgram::Status::Succeeded || state.status == AsyncProgram::Status::Failed)
+            {
+                it = m_pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return Pending();
+    }
+    bool AsyncProgramBuilder::IsComplete(const AsyncProgram::State& state) const
+    {
+        int complete{ true };
+        if (state.status == AsyncProgram::Status::Compiling)
+        {
+            for (int i{}; i < 3 && complete; i++)
+            {
+                if (state.shader[i])
+                {
+                    gltk_GLCheck(glGetShaderiv(state.shader[i], GL_COMPLETION_STATUS_KHR, &complete));
+                }
+            }
+        }
+        else
+        {
+            gltk_GLCheck(glGetProgramiv(state.program, GL_COMPLETION_STATUS_KHR, &complete));
+        }
+        return complete;
+    }
+    void AsyncProgramBuilder::FinishCompile(AsyncProgram::State& state)
+    {
+        for (int i{}; i < 3; i++)
+        {
+            if (!state.shader[i])
+            {
+                continue;
+            }
+
+            int success{ true };
+            gltk_GLCheck(glGetShaderiv(state.shader[i], GL_COMPILE_STATUS, &success));
+            if (!success)
+            {
+                char info_log[INFO_LOG_SIZE]{};
+                gltk_GLCheck(glGetShaderInfoLog(state.shader[i], INFO_LOG_SIZE, nullptr, info_log));
+                state.info_log = std::format("{} shader: {}", STAGE_NAME[i], info_log);
+                state.status = AsyncProgram::Status::Failed;
+                DeleteShaders(state);
+                return;
+            }
+        }
+
+        gltk_GLCheck(state.program = glCreateProgram());
+        for (int i{}; i < 3; i++)
+        {
+            if (state.shader[i])
+            {
+                gltk_GLCheck(glAttachShader(state.program, state.shader[i]));
+            }
+        }
+        if (m_cache && m_cache->Enabled())
+        {
+            gltk_GLCheck(glProgramParameteri(state.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+        gltk_GLCheck(glLinkProgram(state.program));
+        state.status = AsyncProgram::Status::Linking;
+    }
+    void AsyncProgramBuilder::FinishLink(AsyncProgram::State& state)
+    {
+        DeleteShaders(state);
+
+        int success{ false };
+        gltk_GLCheck(glGetProgramiv(state.program, GL_LINK_STATUS, &success));
+        if (!success)
+        {
+            char info_log[INFO_LOG_SIZE]{};
+            gltk_GLCheck(glGetProgramInfoLog(state.program, INFO_LOG_SIZE, nullptr, info_log));
+            state.info_log = info_log;
+            gltk_GLCheck(glDeleteProgram(state.program));
+            state.program = 0;
+            state.status = AsyncProgram::Status::Failed;
+            return;
+        }
+
+        state.status = AsyncProgram::Status::Succeeded;
+    }
+    void AsyncProgramBuilder::DeleteShaders(AsyncProgram::State& state)
+    {
+        for (GLuint& shader : state.shader)
+        {
+            if (shader)
+            {
+                gltk_GLCheck(glDeleteShader(shader));
+                shader = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#include <gltk/Check.h>
+
+#include <format>
+#include <iostream>
+#include <iterator>
+
+namespace gltk
+{
+    void ReportVerifyFailure(const char* file, int line, const char* message)
+    {
+        // no stacktrace here: failed verifications are expected to be recoverable and may be frequent
+        std::format_to(std::ostreambuf_iterator<char>{ std::cerr }, "[CHECK]:{}({}): {}\n", file, line, message);
+    }
+}
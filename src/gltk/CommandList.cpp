@@ -0,0 +1,152 @@
+#include <gltk/CommandList.h>
+
+#include <algorithm>
+
+namespace gltk
+{
+    CommandList::CommandList()
+        : m_commands{}
+        , m_next{}
+        , m_blocks{}
+        , m_block_idx{}
+        , m_block_offset{}
+        , m_bytes{}
+        , m_frame{}
+        , m_input_time{}
+    {
+    }
+    CommandList::~CommandList()
+    {
+        Clear();
+    }
+    void CommandList::Execute()
+    {
+        // whatever a throwing command left behind is destroyed without running
+        auto clear_on_exit{ sg::make_scope_guard([this]() { Clear(); }) };
+        while (m_next < m_commands.size())
+        {
+            const Entry& entry{ m_commands[m_next++] };
+            entry.invoke(entry.command, true);
+        }
+    }
+    void CommandList::Clear()
+    {
+        while (m_next < m_commands.size())
+        {
+            const Entry& entry{ m_commands[m_next++] };
+            entry.invoke(entry.command, false);
+        }
+        m_commands.clear();
+        m_next = 0;
+        m_block_idx = 0;
+        m_block_offset = 0;
+        m_bytes = 0;
+    }
+    void* CommandList::Allocate(std::size_t size, std::size_t alignment)
+    {
+        m_bytes += size;
+        while (true)
+        {
+            if (m_block_idx == m_blocks.size())
+            {
+                std::size_t block_size{ std::max(size, BLOCK_SIZE) };
+                m_blocks.push_back({ std::make_unique<std::byte[]>(block_size), block_size });
+            }
+
+            Block& block{ m_blocks[m_block_idx] };
+            std::size_t begin{ (m_block_offset + alignment - 1) / alignment * alignment };
+            if (begin + size <= block.size)
+            {
+                m_block_offset = begin + size;
+                return block.data.get() + begin;
+            }
+
+            // blocks too small for this command are skipped and reused by the next frames
+            m_block_idx++;
+            m_block_offset = 0;
+        }
+    }
+
+    CommandQueue::CommandQueue()
+        : m_lists{}
+        , m_states{ SlotState::Free, SlotState::Free }
+        , m_record_idx{}
+        , m_replay_idx{}
+        , m_published{}
+        , m_record_wait_ns{}
+        , m_replay_wait_ns{}
+    {
+    }
+    CommandQueueStats CommandQueue::Stats() const noexcept
+    {
+        CommandQueueStats stats{};
+        stats.published = m_published.load(std::memory_order_relaxed);
+        stats.record_wait = std::chrono::nanoseconds{ m_record_wait_ns.load(std::memory_order_relaxed) };
+        stats.replay_wait = std::chrono::nanoseconds{ m_replay_wait_ns.load(std::memory_order_relaxed) };
+        return stats;
+    }
+    CommandList* CommandQueue::BeginRecord()
+    {
+        return Transition(m_record_idx, SlotState::Free, SlotState::Recording, m_record_wait_ns) ? &m_lists[m_record_idx] : nullptr;
+    }
+    void CommandQueue::EndRecord()
+    {
+        if (Transition(m_record_idx, SlotState::Recording, SlotState::Ready, m_record_wait_ns))
+        {
+            m_published.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_record_idx ^= 1;
+    }
+    CommandList* CommandQueue::BeginReplay()
+    {
+        return Transition(m_replay_idx, SlotState::Ready, SlotState::Replaying, m_replay_wait_ns) ? &m_lists[m_replay_idx] : nullptr;
+    }
+    void CommandQueue::EndReplay()
+    {
+        Transition(m_replay_idx, SlotState::Replaying, SlotState::Free, m_replay_wait_ns);
+        m_replay_idx ^= 1;
+    }
+    void CommandQueue::Close()
+    {
+        for (std::atomic<SlotState>& state : m_states)
+        {
+            state.store(SlotState::Closed, std::memory_order_release);
+            state.notify_all();
+        }
+    }
+    bool CommandQueue::Transition(int slot, SlotState from, SlotState to, std::atomic<std::int64_t>& wait_ns)
+    {
+        std::atomic<SlotState>& state{ m_states[slot] };
+        std::chrono::steady_clock::time_point wait_start{};
+        while (true)
+        {
+            SlotState current{ state.load(std::memory_order_acquire) };
+            if (current == SlotState::Closed)
+            {
+                return false;
+            }
+            if (current == from)
+            {
+                // only Close races with the owner of the slot, a failed exchange means it was closed
+                if (state.compare_exchange_strong(current, to, std::memory_order_acq_rel))
+                {
+                    state.notify_all();
+                    break;
+                }
+                continue;
+            }
+
+            if (wait_start == std::chrono::steady_clock::time_point{})
+            {
+                wait_start = std::chrono::steady_clock::now();
+            }
+            state.wait(current, std::memory_order_acquire);
+        }
+
+        if (wait_start != std::chrono::steady_clock::time_point{})
+        {
+            wait_ns.fetch_add((std::chrono::steady_clock::now() - wait_start).count(), std::memory_order_relaxed);
+        }
+        return true;
+    }
+}
@@ -1,7 +1,6 @@
 #include <gltk/Crash.h>
 
 #include <format>
-#include <stacktrace>
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -9,10 +8,22 @@
 
 namespace gltk
 {
-    Crash::Crash(const std::string& file, int line, const std::string message)
-        : m_what{ std::format("{}({}): {}\n{}", file, line, message, std::stacktrace::current(1)) }
+    Crash::Crash(const char* file, int line, std::string message)
+        : m_file{ file }
+        , m_line{ line }
+        , m_message{ std::move(message) }
+        , m_stacktrace{ std::stacktrace::current(1) }
+        , m_what{}
     {
     }
+    const std::string& Crash::What() const
+    {
+        if (m_what.empty())
+        {
+            m_what = std::format("{}({}): {}\n{}", m_file, m_line, m_message, m_stacktrace);
+        }
+        return m_what;
+    }
 
     void TryDebugBreak()
     {
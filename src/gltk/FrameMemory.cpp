@@ -0,0 +1,213 @@
+#include <gltk/FrameMemory.h>
+#include <gltk/Check.h>
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+namespace gltk
+{
+    FrameArena::FrameArena(std::size_t capacity, std::pmr::memory_resource* upstream)
+        : m_upstream{ upstream }
+        , m_buffer{}
+        , m_capacity{ capacity }
+        , m_offset{}
+        , m_last_offset{}
+        , m_spilled{}
+        , m_spills{}
+        , m_high_water{}
+        , m_stats{}
+        , m_last_frame{}
+    {
+        gltk_Check(m_upstream && m_capacity > 0);
+        m_buffer = static_cast<std::byte*>(m_upstream->allocate(m_capacity, alignof(std::max_align_t)));
+    }
+    FrameArena::~FrameArena()
+    {
+        for (const Spill& spill : m_spills)
+        {
+            m_upstream->deallocate(spill.ptr, spill.size, spill.alignment);
+        }
+        m_upstream->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+    }
+    void FrameArena::Reset()
+    {
+        for (const Spill& spill : m_spills)
+        {
+            m_upstream->deallocate(spill.ptr, spill.size, spill.alignment);
+        }
+        m_spills.clear();
+
+        // grow so that a frame like this one fits next time, never shrink: an over-aligned request spills in a
+        // light frame too
+        std::size_t capacity{ std::max(m_capacity, std::bit_ceil(m_stats.peak)) };
+        if (m_spilled > 0 && capacity > m_capacity)
+        {
+            m_upstream->deallocate(m_buffer, m_capacity, alignof(std::max_align_t));
+            m_buffer = static_cast<std::byte*>(m_upstream->allocate(capacity, alignof(std::max_align_t)));
+            m_capacity = capacity;
+        }
+
+        m_offset = 0;
+        m_last_offset = 0;
+        m_spilled = 0;
+        m_high_water = std::max(m_high_water, m_stats.peak);
+        m_last_frame = m_stats;
+        m_stats = {};
+    }
+    void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        m_stats.allocations++;
+        m_stats.bytes += bytes;
+
+        std::size_t begin{ (m_offset + alignment - 1) / alignment * alignment };
+        if (alignment <= alignof(std::max_align_t) && begin + bytes <= m_capacity)
+        {
+            m_last_offset = begin;
+            m_offset = begin + bytes;
+            m_stats.peak = std::max(m_stats.peak, m_offset + m_spilled);
+            return m_buffer + begin;
+        }
+
+        void* ptr{ m_upstream->allocate(bytes, alignment) };
+        m_spills.push_back({ ptr, bytes, alignment });
+        m_spilled += bytes;
+        m_stats.upstream_allocations++;
+        m_stats.peak = std::max(m_stats.peak, m_offset + m_spilled);
+        return ptr;
+    }
+    void FrameArena::do_deallocate(void* ptr, std::size_t bytes, std::size_t /*alignment*/)
+    {
+        m_stats.deallocations++;
+
+        // spills are released by Reset, and only the last allocation can be given back to the arena
+        if (ptr == m_buffer + m_last_offset && m_last_offset + bytes == m_offset)
+        {
+            m_offset = m_last_offset;
+        }
+    }
+
+    FramePool::FramePool(std::pmr::memory_resource* upstream)
+        : m_upstream{ upstream }
+        , m_classes{}
+        , m_large{}
+        , m_in_use{}
+        , m_high_water{}
+        , m_stats{}
+        , m_last_frame{}
+    {
+        gltk_Check(m_upstream);
+    }
+    FramePool::~FramePool()
+    {
+        for (const LargeBlock& block : m_large)
+        {
+            m_upstream->deallocate(block.ptr, block.size, block.alignment);
+        }
+        for (SizeClass& size_class : m_classes)
+        {
+            for (std::byte* chunk : size_class.chunks)
+            {
+                m_upstream->deallocate(chunk, CHUNK_SIZE, alignof(std::max_align_t));
+            }
+        }
+    }
+    std::size_t FramePool::Reserved() const noexcept
+    {
+        std::size_t chunks{};
+        for (const SizeClass& size_class : m_classes)
+        {
+            chunks += size_class.chunks.size();
+        }
+        return chunks * CHUNK_SIZE;
+    }
+    void FramePool::Reset()
+    {
+        // large blocks still alive are released like every other block
+        for (const LargeBlock& block : m_large)
+        {
+            m_upstream->deallocate(block.ptr, block.size, block.alignment);
+        }
+        m_large.clear();
+        for (SizeClass& size_class : m_classes)
+        {
+            size_class.free = nullptr;
+            size_class.chunk_idx = 0;
+            size_class.carve_offset = 0;
+        }
+
+        m_in_use = 0;
+        m_high_water = std::max(m_high_water, m_stats.peak);
+        m_last_frame = m_stats;
+        m_stats = {};
+    }
+    int FramePool::SizeClassIdx(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (bytes > MAX_BLOCK_SIZE || alignment > alignof(std::max_align_t))
+        {
+            return -1;
+        }
+        std::size_t block_size{ std::bit_ceil(std::max(bytes, MIN_BLOCK_SIZE)) };
+        return std::countr_zero(block_size) - std::countr_zero(MIN_BLOCK_SIZE);
+    }
+    void* FramePool::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        m_stats.allocations++;
+        m_stats.bytes += bytes;
+
+        int idx{ SizeClassIdx(bytes, alignment) };
+        if (idx < 0)
+        {
+            void* ptr{ m_upstream->allocate(bytes, alignment) };
+            m_large.push_back({ ptr, bytes, alignment });
+            m_stats.upstream_allocations++;
+            m_in_use += bytes;
+            m_stats.peak = std::max(m_stats.peak, m_in_use);
+            return ptr;
+        }
+
+        SizeClass& size_class{ m_classes[idx] };
+        std::size_t block_size{ MIN_BLOCK_SIZE << idx };
+        m_in_use += block_size;
+        m_stats.peak = std::max(m_stats.peak, m_in_use);
+        if (FreeBlock* block{ size_class.free })
+        {
+            size_class.free = block->next;
+            return block;
+        }
+
+        // blocks are carved at multiples of their size, which keeps them aligned to max_align_t
+        if (size_class.carve_offset + block_size > CHUNK_SIZE)
+        {
+            size_class.chunk_idx++;
+            size_class.carve_offset = 0;
+        }
+        if (size_class.chunk_idx == size_class.chunks.size())
+        {
+            size_class.chunks.push_back(static_cast<std::byte*>(m_upstream->allocate(CHUNK_SIZE, alignof(std::max_align_t))));
+            m_stats.upstream_allocations++;
+        }
+        std::byte* block{ size_class.chunks[size_class.chunk_idx] + size_class.carve_offset };
+        size_class.carve_offset += block_size;
+        return block;
+    }
+    void FramePool::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+    {
+        m_stats.deallocations++;
+
+        int idx{ SizeClassIdx(bytes, alignment) };
+        if (idx < 0)
+        {
+            auto it{ std::ranges::find(m_large, ptr, &LargeBlock::ptr) };
+            gltk_Check(it != m_large.end());
+            m_large.erase(it);
+            m_in_use -= bytes;
+            m_upstream->deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        SizeClass& size_class{ m_classes[idx] };
+        m_in_use -= MIN_BLOCK_SIZE << idx;
+        size_class.free = ::new (ptr) FreeBlock{ size_class.free };
+    }
+}
@@ -0,0 +1,76 @@
+#include <gltk/FramePacing.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace gltk
+{
+    static void PushSample(std::vector<double>& ring, std::int64_t idx, double value)
+    {
+        if (ring.size() < static_cast<std::size_t>(FramePacing::WINDOW))
+        {
+            ring.push_back(value);
+        }
+        else
+        {
+            ring[idx % FramePacing::WINDOW] = value;
+        }
+    }
+    static double Percentile(std::vector<double> samples, double p)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::size_t idx{ std::min(samples.size() - 1, static_cast<std::size_t>(std::ceil(p * static_cast<double>(samples.size()))) - 1) };
+        std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+        return samples[idx];
+    }
+    static double Mean(const std::vector<double>& samples)
+    {
+        double sum{};
+        for (double sample : samples)
+        {
+            sum += sample;
+        }
+        return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+    }
+
+    FramePacing::FramePacing()
+        : m_mutex{}
+        , m_frames{}
+        , m_last_present{}
+        , m_intervals_ms{}
+        , m_latencies_ms{}
+    {
+    }
+    FramePacingStats FramePacing::Stats() const
+    {
+        std::lock_guard lock{ m_mutex };
+        FramePacingStats stats{};
+        stats.frames = m_frames;
+        stats.interval_mean_ms = Mean(m_intervals_ms);
+        double variance{};
+        for (double interval : m_intervals_ms)
+        {
+            variance += (interval - stats.interval_mean_ms) * (interval - stats.interval_mean_ms);
+        }
+        stats.interval_stddev_ms = m_intervals_ms.empty() ? 0.0 : std::sqrt(variance / static_cast<double>(m_intervals_ms.size()));
+        stats.interval_p99_ms = Percentile(m_intervals_ms, 0.99);
+        stats.latency_mean_ms = Mean(m_latencies_ms);
+        stats.latency_p99_ms = Percentile(m_latencies_ms, 0.99);
+        return stats;
+    }
+    void FramePacing::Present(std::chrono::steady_clock::time_point input_time)
+    {
+        auto now{ std::chrono::steady_clock::now() };
+        std::lock_guard lock{ m_mutex };
+        if (m_frames > 0)
+        {
+            PushSample(m_intervals_ms, m_frames - 1, std::chrono::duration<double, std::milli>(now - m_last_present).count());
+        }
+        PushSample(m_latencies_ms, m_frames, std::chrono::duration<double, std::milli>(now - input_time).count());
+        m_last_present = now;
+        m_frames++;
+    }
+}
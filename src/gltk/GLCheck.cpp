@@ -4,24 +4,52 @@
 
 #include <format>
 #include <iostream>
+#include <iterator>
 
 namespace gltk
 {
+    static const char* GetGLErrorString(GLenum error_code)
+    {
+        const char* error{ "" };
+        switch (error_code)
+        {
+        case GL_INVALID_ENUM: { error = "GL_INVALID_ENUM"; } break;
+        case GL_INVALID_VALUE: { error = "GL_INVALID_VALUE"; } break;
+        case GL_INVALID_OPERATION: { error = "GL_INVALID_OPERATION"; } break;
+        case GL_OUT_OF_MEMORY: { error = "GL_OUT_OF_MEMORY"; } break;
+        case GL_INVALID_FRAMEBUFFER_OPERATION: { error = "GL_INVALID_FRAMEBUFFER_OPERATION"; } break;
+        }
+        return error;
+    }
+
     void PrintGLErrorsIfAny(const char* file, int line)
     {
         GLenum error_code{};
         while ((error_code = glGetError()) != GL_NO_ERROR)
         {
-            std::string error{};
-            switch (error_code)
+            // formatted straight into the stream, no temporary string
+            std::format_to(std::ostreambuf_iterator<char>{ std::cerr }, "[GL]:{}({}): {}\n", file, line, GetGLErrorString(error_code));
+        }
+    }
+    void CheckGLCalls(const char* file, int line)
+    {
+        GLenum error_code{};
+        while ((error_code = glGetError()) != GL_NO_ERROR)
+        {
+            // any call since the last checkpoint may have raised it, it is reported at the first of them
+            const GLCallSite& first{ g_first_unchecked_gl_call };
+            const GLCallSite& last{ g_last_unchecked_gl_call };
+            if (first.file)
+            {
+                std::format_to(std::ostreambuf_iterator<char>{ std::cerr }, "[GL]:{}({}): {} (raised by a call between {}({}) and {}({}))\n",
+                    first.file, first.line, GetGLErrorString(error_code), first.file, first.line, last.file, last.line);
+            }
+            else
             {
-            case GL_INVALID_ENUM: { error = "GL_INVALID_ENUM"; } break;
-            case GL_INVALID_VALUE: { error = "GL_INVALID_VALUE"; } break;
-            case GL_INVALID_OPERATION: { error = "GL_INVALID_OPERATION"; } break;
-            case GL_OUT_OF_MEMORY: { error = "GL_OUT_OF_MEMORY"; } break;
-            case GL_INVALID_FRAMEBUFFER_OPERATION: { error = "GL_INVALID_FRAMEBUFFER_OPERATION"; } break;
+                std::format_to(std::ostreambuf_iterator<char>{ std::cerr }, "[GL]:{}({}): {} (raised by an unchecked call)\n", file, line, GetGLErrorString(error_code));
             }
-            std::cerr << std::format("[GL]:{}({}): {}\n", file, line, error);
         }
+        g_first_unchecked_gl_call = {};
+        g_last_unchecked_gl_call = {};
     }
 }
@@ -0,0 +1,96 @@
+#include <gltk/GLStateCache.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+namespace gltk
+{
+    int GLStateCache::GetTextureTargetIdx(GLenum target)
+    {
+        int idx{ -1 };
+        switch (target)
+        {
+        case GL_TEXTURE_2D: { idx = 0; } break;
+        case GL_TEXTURE_2D_ARRAY: { idx = 1; } break;
+        case GL_TEXTURE_3D: { idx = 2; } break;
+        case GL_TEXTURE_CUBE_MAP: { idx = 3; } break;
+        default: { gltk_Unreachable(); } break;
+        }
+        return idx;
+    }
+    GLStateCache::GLStateCache()
+        : m_program{}
+        , m_vao{}
+        , m_array_buffer{}
+        , m_active_texture{}
+        , m_texture{}
+        , m_stats{}
+    {
+        Invalidate();
+    }
+    void GLStateCache::UseProgram(GLuint program)
+    {
+        if (m_program == program)
+        {
+            m_stats.binds_avoided++;
+            return;
+        }
+        gltk_GLCheck(glUseProgram(program));
+        m_program = program;
+        m_stats.binds++;
+    }
+    void GLStateCache::BindVertexArray(GLuint vao)
+    {
+        if (m_vao == vao)
+        {
+            m_stats.binds_avoided++;
+            return;
+        }
+        gltk_GLCheck(glBindVertexArray(vao));
+        m_vao = vao;
+        m_stats.binds++;
+    }
+    void GLStateCache::BindArrayBuffer(GLuint buffer)
+    {
+        if (m_array_buffer == buffer)
+        {
+            m_stats.binds_avoided++;
+            return;
+        }
+        gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+        m_array_buffer = buffer;
+        m_stats.binds++;
+    }
+    void GLStateCache::BindTexture(int unit, GLenum target, GLuint texture)
+    {
+        gltk_Check(0 <= unit && unit < MAX_TEXTURE_UNITS);
+        GLuint& bound{ m_texture[unit][GetTextureTargetIdx(target)] };
+        if (bound == texture)
+        {
+            m_stats.binds_avoided++;
+            return;
+        }
+        if (m_active_texture != unit)
+        {
+            gltk_GLCheck(glActiveTexture(GL_TEXTURE0 + unit));
+            m_active_texture = unit;
+        }
+        gltk_GLCheck(glBindTexture(target, texture));
+        bound = texture;
+        m_stats.binds++;
+        m_stats.texture_binds++;
+    }
+    void GLStateCache::Invalidate()
+    {
+        m_program = UNKNOWN;
+        m_vao = UNKNOWN;
+        m_array_buffer = UNKNOWN;
+        m_active_texture = -1;
+        for (auto& unit : m_texture)
+        {
+            for (GLuint& texture : unit)
+            {
+                texture = UNKNOWN;
+            }
+        }
+    }
+}
@@ -0,0 +1,251 @@
+#include <gltk/GltfLoader.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <stb_image.h>
+
+#include <format>
+
+namespace gltk
+{
+    float GltfAsset::Progress() const noexcept
+    {
+        // parsing and uploading are accounted as a fixed share, decoding as the rest
+        switch (Stage())
+        {
+        case AssetStage::Parsing: { return 0.0f; }
+        case AssetStage::Decoding:
+        {
+            float decoded{ static_cast<float>(m_state->images_decoded.load(std::memory_order_relaxed)) };
+            return 0.1f + 0.8f * decoded / static_cast<float>(m_state->images_total);
+        }
+        case AssetStage::Uploading: { return 0.9f; }
+        default: { return 1.0f; }
+        }
+    }
+
+    GltfLoader::GltfLoader(ThreadPool& pool)
+        : m_pool{ pool }
+        , m_pending{}
+    {
+    }
+    GltfAsset GltfLoader::Load(const std::filesystem::path& path)
+    {
+        auto state{ std::make_shared<GltfAsset::State>() };
+        state->path = path;
+        state->stage.store(AssetStage::Parsing, std::memory_order_relaxed);
+        state->start_time = std::chrono::steady_clock::now();
+
+        m_pending.push_back(state);
+        m_pool.Submit([&pool = m_pool, state]() { Parse(pool, state); });
+        return GltfAsset{ state };
+    }
+    int GltfLoader::Update(int max_uploads)
+    {
+        int uploads{};
+        for (auto it{ m_pending.begin() }; it != m_pending.end();)
+        {
+            GltfAsset::State& state{ **it };
+            AssetStage stage{ state.stage.load(std::memory_order_acquire) };
+            if (stage == AssetStage::Uploading && uploads < max_uploads)
+            {
+                Upload(state);
+                uploads++;
+                state.stage.store(AssetStage::Ready, std::memory_order_release);
+                it = m_pending.erase(it);
+            }
+            else if (stage == AssetStage::Failed)
+            {
+                it = m_pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        return Pending();
+    }
+    void GltfLoader::Unload(GltfAsset& asset)
+    {
+        gltk_Check(asset.Valid() && asset.Stage() == AssetStage::Ready);
+        GltfAsset::State& state{ *asset.m_state };
+        gltk_GLCheck(glDeleteBuffers(static_cast<GLsizei>(state.buffers.size()), state.buffers.data()));
+        gltk_GLCheck(glDeleteTextures(static_cast<GLsizei>(state.textures.size()), state.textures.data()));
+        asset = {};
+    }
+    void GltfLoader::Parse(ThreadPool& pool, const std::shared_ptr<GltfAsset::State>& state)
+    {
+        // keep images encoded, they get decoded in parallel below
+        tinygltf::TinyGLTF gltf{};
+        gltf.SetImagesAsIs(true);
+
+        std::string err{};
+        std::string warn{};
+        bool success{};
+        if (state->path.extension() == ".glb")
+        {
+            success = gltf.LoadBinaryFromFile(&state->model, &err, &warn, state->path.string());
+        }
+        else
+        {
+            success = gltf.LoadASCIIFromFile(&state->model, &err, &warn, state->path.string());
+        }
+
+        // tinygltf does not check that buffer views lie within their buffer, and Upload copies them as they are
+        for (std::size_t i{}; success && i < state->model.bufferViews.size(); i++)
+        {
+            const tinygltf::BufferView& view{ state->model.bufferViews[i] };
+            if (view.buffer < 0 || view.buffer >= static_cast<int>(state->model.buffers.size())
+                || view.byteOffset > state->model.buffers[view.buffer].data.size()
+                || view.byteLength > state->model.buffers[view.buffer].data.size() - view.byteOffset)
+            {
+                err = std::format("buffer view {} is out of the range of its buffer", i);
+                success = false;
+            }
+        }
+
+        state->parsed_time = std::chrono::steady_clock::now();
+        state->timings.parse = state->parsed_time - state->start_time;
+        if (!success)
+        {
+            state->error = err;
+            state->timings.total = state->timings.parse;
+            state->stage.store(AssetStage::Failed, std::memory_order_release);
+            return;
+        }
+
+        state->images_total = static_cast<int>(state->model.images.size());
+        if (state->images_total == 0)
+        {
+            state->decoded_time = state->parsed_time;
+            state->stage.store(AssetStage::Uploading, std::memory_order_release);
+            return;
+        }
+
+        state->stage.store(AssetStage::Decoding, std::memory_order_release);
+        for (int i{}; i < state->images_total; i++)
+        {
+            pool.Submit([state, i]() { Decode(state, i); });
+        }
+    }
+    void GltfLoader::Decode(const std::shared_ptr<GltfAsset::State>& state, int image_idx)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+
+        tinygltf::Image& image{ state->model.images[image_idx] };
+        if (image.as_is && !image.image.empty())
+        {
+            int w{};
+            int h{};
+            int comp{};
+            stbi_uc* pixels{ stbi_load_from_memory(image.image.data(), static_cast<int>(image.image.size()), &w, &h, &comp, 4) };
+            if (pixels)
+            {
+                image.image.assign(pixels, pixels + static_cast<std::size_t>(w) * h * 4);
+                stbi_image_free(pixels);
+                image.width = w;
+                image.height = h;
+                image.component = 4;
+                image.bits = 8;
+                image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+                image.as_is = false;
+            }
+            else
+            {
+                image.image.clear();
+            }
+        }
+
+        auto end{ std::chrono::steady_clock::now() };
+        state->decode_cpu_ns.fetch_add(std::chrono::nanoseconds{ end - start }.count(), std::memory_order_relaxed);
+
+        // the last image to finish hands the asset over to the context thread
+        if (state->images_decoded.fetch_add(1, std::memory_order_acq_rel) + 1 == state->images_total)
+        {
+            state->decoded_time = end;
+            state->stage.store(AssetStage::Uploading, std::memory_order_release);
+        }
+    }
+    void GltfLoader::Upload(GltfAsset::State& state)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+        tinygltf::Model& model{ state.model };
+
+        // target is optional and often omitted, so views are also recognized as vertex or index data by the
+        // primitives whose accessors read them
+        std::vector<bool> geometry_views(model.bufferViews.size());
+        auto mark_accessor{ [&](int accessor)
+        {
+            if (accessor >= 0 && accessor < static_cast<int>(model.accessors.size()))
+            {
+                int view{ model.accessors[accessor].bufferView };
+                if (view >= 0 && view < static_cast<int>(geometry_views.size()))
+                {
+                    geometry_views[view] = true;
+                }
+            }
+        } };
+        for (const tinygltf::Mesh& mesh : model.meshes)
+        {
+            for (const tinygltf::Primitive& primitive : mesh.primitives)
+            {
+                for (const auto& [name, accessor] : primitive.attributes)
+                {
+                    mark_accessor(accessor);
+                }
+                for (const std::map<std::string, int>& target : primitive.targets)
+                {
+                    for (const auto& [name, accessor] : target)
+                    {
+                        mark_accessor(accessor);
+                    }
+                }
+                mark_accessor(primitive.indices);
+            }
+        }
+
+        // buffer objects are untyped, so vertex and index data both go through GL_ARRAY_BUFFER here
+        state.buffers.assign(model.bufferViews.size(), 0);
+        for (std::size_t i{}; i < model.bufferViews.size(); i++)
+        {
+            const tinygltf::BufferView& view{ model.bufferViews[i] };
+            if (view.target != TINYGLTF_TARGET_ARRAY_BUFFER && view.target != TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER && !geometry_views[i])
+            {
+                continue;
+            }
+
+            const tinygltf::Buffer& buffer{ model.buffers[view.buffer] };
+            gltk_GLCheck(glGenBuffers(1, &state.buffers[i]));
+            gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, state.buffers[i]));
+            gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, view.byteLength, buffer.data.data() + view.byteOffset, GL_STATIC_DRAW));
+        }
+        gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        // image data is a client pointer, which an unpack buffer left bound by someone else would turn into an offset
+        gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        state.textures.assign(model.images.size(), 0);
+        for (std::size_t i{}; i < model.images.size(); i++)
+        {
+            const tinygltf::Image& image{ model.images[i] };
+            if (image.as_is || image.image.empty())
+            {
+                continue;
+            }
+
+            gltk_GLCheck(glGenTextures(1, &state.textures[i]));
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, state.textures[i]));
+            gltk_GLCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.image.data()));
+            gltk_GLCheck(glGenerateMipmap(GL_TEXTURE_2D));
+            gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+            gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        }
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+        auto end{ std::chrono::steady_clock::now() };
+        state.timings.decode = state.decoded_time - state.parsed_time;
+        state.timings.decode_cpu = std::chrono::nanoseconds{ state.decode_cpu_ns.load(std::memory_order_relaxed) };
+        state.timings.wait = start - state.decoded_time;
+        state.timings.upload = end - start;
+        state.timings.total = end - state.start_time;
+    }
+}
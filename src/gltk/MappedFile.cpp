@@ -0,0 +1,89 @@
+#include <gltk/MappedFile.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gltk
+{
+    #if defined(_WIN32)
+    MappedFile::MappedFile(const std::filesystem::path& path)
+        : m_data{}
+        , m_size{}
+        , m_file{ INVALID_HANDLE_VALUE }
+        , m_mapping{}
+    {
+        m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+        {
+            return;
+        }
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping)
+        {
+            return;
+        }
+
+        m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size = m_data ? static_cast<std::size_t>(size.QuadPart) : 0;
+    }
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(m_file);
+        }
+    }
+    #else
+    MappedFile::MappedFile(const std::filesystem::path& path)
+        : m_data{}
+        , m_size{}
+    {
+        int fd{ open(path.c_str(), O_RDONLY) };
+        if (fd < 0)
+        {
+            return;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* data{ mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0) };
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<const std::byte*>(data);
+                m_size = static_cast<std::size_t>(st.st_size);
+            }
+        }
+        close(fd);
+    }
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+    }
+    #endif
+}
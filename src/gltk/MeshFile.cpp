@@ -0,0 +1,112 @@
+#include <gltk/MeshFile.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace gltk
+{
+    template <typename T>
+    static bool IndicesInRange(const T* indices, std::uint32_t count, std::uint32_t vertex_count)
+    {
+        T max_index{};
+        for (std::uint32_t i{}; i < count; i++)
+        {
+            max_index = std::max(max_index, indices[i]);
+        }
+        return count == 0 || max_index < vertex_count;
+    }
+
+    MeshFile::MeshFile(const std::filesystem::path& path)
+        : m_file{ path }
+        , m_header{}
+    {
+        if (!m_file.Valid() || m_file.Size() < sizeof(MeshFileHeader))
+        {
+            return;
+        }
+
+        // mappings are page aligned, so the header can be used in place
+        const MeshFileHeader* header{ reinterpret_cast<const MeshFileHeader*>(m_file.Data().data()) };
+        std::size_t index_size{ header->index_type == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t) };
+        bool valid{ std::memcmp(header->magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC)) == 0
+            && (header->index_type == GL_UNSIGNED_SHORT || header->index_type == GL_UNSIGNED_INT)
+            && header->vertex_stride == sizeof(PackedVertex)
+            && header->vertex_offset <= m_file.Size() && header->vertex_count <= (m_file.Size() - header->vertex_offset) / sizeof(PackedVertex)
+            && header->index_offset <= m_file.Size() && header->index_count <= (m_file.Size() - header->index_offset) / index_size
+            && header->index_offset % index_size == 0 };
+        if (!valid)
+        {
+            return;
+        }
+
+        // the indices go straight into an element buffer, one out of range would make the GPU read past the vertices
+        const std::byte* indices{ m_file.Data().data() + header->index_offset };
+        valid = header->index_type == GL_UNSIGNED_SHORT
+            ? IndicesInRange(reinterpret_cast<const std::uint16_t*>(indices), header->index_count, header->vertex_count)
+            : IndicesInRange(reinterpret_cast<const std::uint32_t*>(indices), header->index_count, header->vertex_count);
+        if (valid)
+        {
+            m_header = header;
+        }
+    }
+    std::span<const std::byte> MeshFile::Vertices() const noexcept
+    {
+        return m_file.Data().subspan(m_header->vertex_offset, m_header->vertex_count * sizeof(PackedVertex));
+    }
+    std::span<const std::byte> MeshFile::Indices() const noexcept
+    {
+        std::size_t index_size{ m_header->index_type == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t) };
+        return m_file.Data().subspan(m_header->index_offset, m_header->index_count * index_size);
+    }
+
+    GpuMesh::GpuMesh(const MeshFile& file)
+        : m_vbo{}
+        , m_ebo{}
+        , m_vao{}
+        , m_count{}
+        , m_index_type{}
+        , m_uv_offset{}
+        , m_uv_scale{}
+        , m_center{}
+        , m_radius{}
+    {
+        gltk_Check(file.Valid());
+        const MeshFileHeader& header{ file.Header() };
+        m_count = static_cast<GLsizei>(header.index_count);
+        m_index_type = header.index_type;
+        m_uv_offset = { header.uv_offset[0], header.uv_offset[1] };
+        m_uv_scale = { header.uv_scale[0], header.uv_scale[1] };
+        m_center = { header.center[0], header.center[1], header.center[2] };
+        m_radius = header.radius;
+
+        // straight from the mapping, the data already is in its GL layout
+        gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+        gltk_GLCheck(glGenBuffers(1, &m_vbo));
+        gltk_GLCheck(glGenBuffers(1, &m_ebo));
+        gltk_GLCheck(glBindVertexArray(m_vao));
+        gltk_GLCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+        gltk_GLCheck(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(file.Vertices().size()), file.Vertices().data(), GL_STATIC_DRAW));
+        gltk_GLCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo));
+        gltk_GLCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(file.Indices().size()), file.Indices().data(), GL_STATIC_DRAW));
+
+        gltk_GLCheck(glEnableVertexAttribArray(POSITION_ATTRIB));
+        gltk_GLCheck(glVertexAttribPointer(POSITION_ATTRIB, 4, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), reinterpret_cast<const void*>(offsetof(PackedVertex, position))));
+        gltk_GLCheck(glEnableVertexAttribArray(NORMAL_ATTRIB));
+        gltk_GLCheck(glVertexAttribPointer(NORMAL_ATTRIB, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), reinterpret_cast<const void*>(offsetof(PackedVertex, normal))));
+        gltk_GLCheck(glEnableVertexAttribArray(UV_ATTRIB));
+        gltk_GLCheck(glVertexAttribPointer(UV_ATTRIB, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), reinterpret_cast<const void*>(offsetof(PackedVertex, uv))));
+        gltk_GLCheck(glBindVertexArray(0));
+    }
+    GpuMesh::~GpuMesh()
+    {
+        gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+        gltk_GLCheck(glDeleteBuffers(1, &m_ebo));
+        gltk_GLCheck(glDeleteBuffers(1, &m_vbo));
+    }
+    SceneMesh GpuMesh::AsSceneMesh() const noexcept
+    {
+        return { .vao = m_vao, .count = m_count, .index_type = m_index_type, .center = m_center, .radius = m_radius };
+    }
+}
@@ -0,0 +1,626 @@
+#include <gltk/MeshOptimizer.h>
+#include <gltk/Check.h>
+#include <gltk/MeshFile.h>
+
+#include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+
+namespace gltk
+{
+    namespace
+    {
+        // Forsyth's scoring, tuned for a 32 entry LRU cache
+        constexpr int SCORE_CACHE_SIZE{ 32 };
+        constexpr float LAST_TRIANGLE_SCORE{ 0.75f };
+        constexpr float CACHE_DECAY_POWER{ 1.5f };
+        constexpr float VALENCE_BOOST_SCALE{ 2.0f };
+        constexpr float VALENCE_BOOST_POWER{ -0.5f };
+
+        constexpr std::size_t MESH_FILE_ALIGNMENT{ 16 };
+        constexpr std::uint32_t MAX_SHORT_INDEX_VERTICES{ 0xFFFF };
+
+        float VertexScore(int cache_position, std::uint32_t remaining)
+        {
+            if (remaining == 0)
+            {
+                return -1.0f; // nothing left to draw with this vertex
+            }
+
+            float score{};
+            if (cache_position >= 0)
+            {
+                // the vertices of the last triangle get a fixed score, so that the next one does not reuse them all
+                if (cache_position < 3)
+                {
+                    score = LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    float scale{ 1.0f / static_cast<float>(SCORE_CACHE_SIZE - 3) };
+                    score = std::pow(1.0f - static_cast<float>(cache_position - 3) * scale, CACHE_DECAY_POWER);
+                }
+            }
+            // favour vertices with few triangles left, so that they get finished instead of becoming isolated
+            return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining), VALENCE_BOOST_POWER);
+        }
+
+        std::size_t AlignUp(std::size_t value, std::size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        GLenum MeshIndexType(const MeshData& mesh)
+        {
+            return mesh.positions.size() <= MAX_SHORT_INDEX_VERTICES ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
+        glm::vec2 EncodeOctahedral(glm::vec3 n)
+        {
+            float l1{ std::abs(n.x) + std::abs(n.y) + std::abs(n.z) };
+            if (!(l1 > 0.0f) || !std::isfinite(l1))
+            {
+                return glm::vec2{ 0.0f }; // degenerate normals decode to (0, 0, 1)
+            }
+            n /= l1;
+            glm::vec2 e{ n.x, n.y };
+            if (n.z < 0.0f)
+            {
+                e = (1.0f - glm::abs(glm::vec2{ e.y, e.x })) * glm::vec2{ e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f };
+            }
+            return e;
+        }
+
+        std::int16_t QuantizeSnorm(float value)
+        {
+            return static_cast<std::int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+        }
+        std::uint16_t QuantizeUnorm(float value)
+        {
+            return static_cast<std::uint16_t>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        // pointer to the first element of an accessor and the distance between elements
+        const unsigned char* AccessorData(const tinygltf::Model& model, int accessor_idx, int type, int component_type,
+            std::size_t& count, std::size_t& stride, std::string& error)
+        {
+            if (accessor_idx < 0 || accessor_idx >= static_cast<int>(model.accessors.size()))
+            {
+                error = std::format("accessor {} does not exist", accessor_idx);
+                return nullptr;
+            }
+            const tinygltf::Accessor& accessor{ model.accessors[accessor_idx] };
+            if (accessor.type != type || accessor.componentType != component_type)
+            {
+                error = std::format("accessor {} has an unsupported type", accessor_idx);
+                return nullptr;
+            }
+            if (accessor.sparse.isSparse || accessor.bufferView < 0)
+            {
+                error = std::format("accessor {} is sparse or has no buffer view", accessor_idx);
+                return nullptr;
+            }
+
+            const tinygltf::BufferView& view{ model.bufferViews[accessor.bufferView] };
+            const tinygltf::Buffer& buffer{ model.buffers[view.buffer] };
+            std::size_t element_size{ static_cast<std::size_t>(tinygltf::GetComponentSizeInBytes(component_type) * tinygltf::GetNumComponentsInType(type)) };
+            count = accessor.count;
+            stride = view.byteStride ? view.byteStride : element_size;
+            std::size_t offset{ view.byteOffset + accessor.byteOffset };
+            if (count > 0 && offset + (count - 1) * stride + element_size > buffer.data.size())
+            {
+                error = std::format("accessor {} is out of the bounds of its buffer", accessor_idx);
+                return nullptr;
+            }
+            return buffer.data.data() + offset;
+        }
+
+        template <typename T>
+        bool ReadAttribute(const tinygltf::Model& model, const tinygltf::Primitive& primitive, const char* name, int type,
+            std::vector<T>& out, std::string& error)
+        {
+            auto it{ primitive.attributes.find(name) };
+            if (it == primitive.attributes.end())
+            {
+                return true;
+            }
+
+            std::size_t count{};
+            std::size_t stride{};
+            const unsigned char* data{ AccessorData(model, it->second, type, TINYGLTF_COMPONENT_TYPE_FLOAT, count, stride, error) };
+            if (!data)
+            {
+                error = std::format("{}: {}", name, error);
+                return false;
+            }
+            out.resize(count);
+            for (std::size_t i{}; i < count; i++)
+            {
+                std::memcpy(&out[i], data + i * stride, sizeof(T));
+            }
+            return true;
+        }
+    }
+
+    VertexCacheStats ComputeVertexCacheStats(std::span<const std::uint32_t> indices, std::uint32_t vertex_count, int cache_size)
+    {
+        // a vertex is in the FIFO if fewer than cache_size misses happened since it was last loaded
+        std::vector<std::uint32_t> loaded_at(vertex_count, 0);
+        std::uint32_t misses{};
+        std::uint32_t time{ static_cast<std::uint32_t>(cache_size) + 1 };
+        for (std::uint32_t index : indices)
+        {
+            gltk_Check(index < vertex_count);
+            if (time - loaded_at[index] > static_cast<std::uint32_t>(cache_size))
+            {
+                loaded_at[index] = time++;
+                misses++;
+            }
+        }
+
+        VertexCacheStats stats{};
+        std::size_t triangles{ indices.size() / 3 };
+        stats.acmr = triangles ? static_cast<float>(misses) / static_cast<float>(triangles) : 0.0f;
+        stats.atvr = vertex_count ? static_cast<float>(misses) / static_cast<float>(vertex_count) : 0.0f;
+        return stats;
+    }
+    void OptimizeVertexCache(std::span<std::uint32_t> indices, std::uint32_t vertex_count)
+    {
+        gltk_Check(indices.size() % 3 == 0);
+        std::size_t triangle_count{ indices.size() / 3 };
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        // triangles of each vertex, the first remaining[v] entries of a vertex are the ones not emitted yet
+        std::vector<std::uint32_t> remaining(vertex_count, 0);
+        for (std::uint32_t index : indices)
+        {
+            gltk_Check(index < vertex_count);
+            remaining[index]++;
+        }
+        std::vector<std::uint32_t> first_adjacency(vertex_count + 1, 0);
+        for (std::uint32_t v{}; v < vertex_count; v++)
+        {
+            first_adjacency[v + 1] = first_adjacency[v] + remaining[v];
+        }
+        std::vector<std::uint32_t> adjacency(indices.size());
+        {
+            std::vector<std::uint32_t> cursor{ first_adjacency.begin(), first_adjacency.end() - 1 };
+            for (std::size_t i{}; i < indices.size(); i++)
+            {
+                adjacency[cursor[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<int> cache_position(vertex_count, -1);
+        std::vector<float> vertex_score(vertex_count);
+        for (std::uint32_t v{}; v < vertex_count; v++)
+        {
+            vertex_score[v] = VertexScore(-1, remaining[v]);
+        }
+        std::vector<float> triangle_score(triangle_count);
+        for (std::size_t t{}; t < triangle_count; t++)
+        {
+            triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+        }
+        std::vector<std::uint8_t> emitted(triangle_count, 0);
+
+        std::vector<std::uint32_t> out{};
+        out.reserve(indices.size());
+        std::vector<std::uint32_t> cache{};
+        std::vector<std::uint32_t> next_cache{};
+        std::size_t scan{}; // for when no triangle touches the cache anymore
+
+        std::size_t best{ static_cast<std::size_t>(std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin()) };
+        while (true)
+        {
+            emitted[best] = 1;
+            const std::uint32_t* triangle{ &indices[best * 3] };
+            out.insert(out.end(), triangle, triangle + 3);
+
+            for (int k{}; k < 3; k++)
+            {
+                std::uint32_t v{ triangle[k] };
+                std::uint32_t* begin{ &adjacency[first_adjacency[v]] };
+                std::uint32_t* end{ begin + remaining[v] };
+                *std::find(begin, end, static_cast<std::uint32_t>(best)) = *(end - 1);
+                remaining[v]--;
+            }
+
+            // the triangle goes to the front of the LRU cache, everything past its size drops out
+            next_cache.assign(triangle, triangle + 3);
+            for (std::uint32_t v : cache)
+            {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                {
+                    next_cache.push_back(v);
+                }
+            }
+            for (std::size_t i{}; i < next_cache.size(); i++)
+            {
+                std::uint32_t v{ next_cache[i] };
+                cache_position[v] = i < SCORE_CACHE_SIZE ? static_cast<int>(i) : -1;
+                vertex_score[v] = VertexScore(cache_position[v], remaining[v]);
+            }
+
+            // only triangles around the cache changed score, the next one is picked among them
+            float best_score{ -1.0f };
+            best = triangle_count;
+            for (std::uint32_t v : next_cache)
+            {
+                for (std::uint32_t i{}; i < remaining[v]; i++)
+                {
+                    std::uint32_t t{ adjacency[first_adjacency[v] + i] };
+                    triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+                    if (triangle_score[t] > best_score)
+                    {
+                        best_score = triangle_score[t];
+                        best = t;
+                    }
+                }
+            }
+
+            if (next_cache.size() > SCORE_CACHE_SIZE)
+            {
+                next_cache.resize(SCORE_CACHE_SIZE);
+            }
+            std::swap(cache, next_cache);
+
+            if (best == triangle_count)
+            {
+                while (scan < triangle_count && emitted[scan])
+                {
+                    scan++;
+                }
+                if (scan == triangle_count)
+                {
+                    break;
+                }
+                best = scan;
+            }
+        }
+
+        std::ranges::copy(out, indices.begin());
+    }
+    void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const glm::vec3> positions, int cache_size)
+    {
+        gltk_Check(indices.size() % 3 == 0);
+        std::size_t triangle_count{ indices.size() / 3 };
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        // a cluster starts wherever all three vertices miss the cache, so reordering clusters keeps the hits
+        std::vector<std::size_t> cluster_begin{};
+        {
+            std::vector<std::uint32_t> loaded_at(positions.size(), 0);
+            std::uint32_t time{ static_cast<std::uint32_t>(cache_size) + 1 };
+            for (std::size_t t{}; t < triangle_count; t++)
+            {
+                int misses{};
+                for (int k{}; k < 3; k++)
+                {
+                    std::uint32_t index{ indices[t * 3 + k] };
+                    gltk_Check(index < positions.size());
+                    if (time - loaded_at[index] > static_cast<std::uint32_t>(cache_size))
+                    {
+                        loaded_at[index] = time++;
+                        misses++;
+                    }
+                }
+                if (misses == 3 || t == 0)
+                {
+                    cluster_begin.push_back(t);
+                }
+            }
+            cluster_begin.push_back(triangle_count);
+        }
+
+        glm::vec3 mesh_centroid{};
+        for (const glm::vec3& position : positions)
+        {
+            mesh_centroid += position;
+        }
+        mesh_centroid /= static_cast<float>(std::max<std::size_t>(positions.size(), 1));
+
+        // clusters whose centroid lies far along their average normal face outwards
+        struct Cluster
+        {
+            std::size_t begin;
+            std::size_t end;
+            float sort_key;
+        };
+        std::vector<Cluster> clusters{};
+        for (std::size_t c{}; c + 1 < cluster_begin.size(); c++)
+        {
+            glm::vec3 centroid{};
+            glm::vec3 normal{};
+            float area{};
+            for (std::size_t t{ cluster_begin[c] }; t < cluster_begin[c + 1]; t++)
+            {
+                const glm::vec3& a{ positions[indices[t * 3]] };
+                const glm::vec3& b{ positions[indices[t * 3 + 1]] };
+                const glm::vec3& p{ positions[indices[t * 3 + 2]] };
+                glm::vec3 cross{ glm::cross(b - a, p - a) }; // length is twice the area
+                float triangle_area{ glm::length(cross) };
+                centroid += (a + b + p) * (triangle_area / 3.0f);
+                normal += cross;
+                area += triangle_area;
+            }
+            centroid = area > 0.0f ? centroid / area : positions[indices[cluster_begin[c] * 3]];
+            float normal_length{ glm::length(normal) };
+            float key{ normal_length > 0.0f ? glm::dot(centroid - mesh_centroid, normal / normal_length) : 0.0f };
+            clusters.push_back({ cluster_begin[c], cluster_begin[c + 1], key });
+        }
+        std::ranges::stable_sort(clusters, [](const Cluster& a, const Cluster& b) { return a.sort_key > b.sort_key; });
+
+        std::vector<std::uint32_t> out{};
+        out.reserve(indices.size());
+        for (const Cluster& cluster : clusters)
+        {
+            out.insert(out.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+        }
+        std::ranges::copy(out, indices.begin());
+    }
+    void OptimizeVertexFetch(MeshData& mesh)
+    {
+        constexpr std::uint32_t UNUSED{ std::numeric_limits<std::uint32_t>::max() };
+        std::vector<std::uint32_t> remap(mesh.positions.size(), UNUSED);
+        std::uint32_t next{};
+        for (std::uint32_t& index : mesh.indices)
+        {
+            gltk_Check(index < remap.size());
+            if (remap[index] == UNUSED)
+            {
+                remap[index] = next++;
+            }
+            index = remap[index];
+        }
+
+        auto reorder{ [&](auto& attribute)
+        {
+            if (attribute.empty())
+            {
+                return;
+            }
+            std::remove_reference_t<decltype(attribute)> reordered(next);
+            for (std::size_t v{}; v < remap.size(); v++)
+            {
+                if (remap[v] != UNUSED)
+                {
+                    reordered[remap[v]] = attribute[v];
+                }
+            }
+            attribute = std::move(reordered);
+        } };
+        reorder(mesh.positions);
+        reorder(mesh.normals);
+        reorder(mesh.uvs);
+    }
+    MeshStats OptimizeMesh(MeshData& mesh)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+        gltk_Check(mesh.normals.empty() || mesh.normals.size() == mesh.positions.size());
+        gltk_Check(mesh.uvs.empty() || mesh.uvs.size() == mesh.positions.size());
+
+        MeshStats stats{};
+        std::uint32_t vertex_count{ static_cast<std::uint32_t>(mesh.positions.size()) };
+        stats.triangles = static_cast<std::uint32_t>(mesh.indices.size() / 3);
+        stats.before = ComputeVertexCacheStats(mesh.indices, vertex_count);
+        stats.input_bytes = mesh.positions.size() * sizeof(glm::vec3) + mesh.normals.size() * sizeof(glm::vec3)
+            + mesh.uvs.size() * sizeof(glm::vec2) + mesh.indices.size() * sizeof(std::uint32_t);
+
+        // the overdraw pass works on cache optimized clusters, and the fetch pass renumbers what both produced
+        OptimizeVertexCache(mesh.indices, vertex_count);
+        OptimizeOverdraw(mesh.indices, mesh.positions);
+        OptimizeVertexFetch(mesh);
+
+        stats.vertices = static_cast<std::uint32_t>(mesh.positions.size());
+        stats.after = ComputeVertexCacheStats(mesh.indices, stats.vertices);
+        stats.output_bytes = MeshFileSize(mesh);
+        stats.time = std::chrono::steady_clock::now() - start;
+        return stats;
+    }
+    bool ExtractGltfPrimitive(const tinygltf::Model& model, const tinygltf::Primitive& primitive, MeshData& mesh, std::string& error)
+    {
+        mesh = {};
+        if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES)
+        {
+            error = "only triangle lists are supported";
+            return false;
+        }
+        if (!primitive.attributes.contains("POSITION"))
+        {
+            error = "primitive has no POSITION attribute";
+            return false;
+        }
+        if (!ReadAttribute(model, primitive, "POSITION", TINYGLTF_TYPE_VEC3, mesh.positions, error)
+            || !ReadAttribute(model, primitive, "NORMAL", TINYGLTF_TYPE_VEC3, mesh.normals, error)
+            || !ReadAttribute(model, primitive, "TEXCOORD_0", TINYGLTF_TYPE_VEC2, mesh.uvs, error))
+        {
+            return false;
+        }
+        if ((!mesh.normals.empty() && mesh.normals.size() != mesh.positions.size()) || (!mesh.uvs.empty() && mesh.uvs.size() != mesh.positions.size()))
+        {
+            error = "attribute counts do not match";
+            return false;
+        }
+
+        if (primitive.indices < 0)
+        {
+            mesh.indices.resize(mesh.positions.size());
+            for (std::uint32_t i{}; i < mesh.indices.size(); i++)
+            {
+                mesh.indices[i] = i;
+            }
+        }
+        else
+        {
+            int component_type{ primitive.indices >= 0 && primitive.indices < static_cast<int>(model.accessors.size()) ? model.accessors[primitive.indices].componentType : -1 };
+            std::size_t count{};
+            std::size_t stride{};
+            const unsigned char* data{ AccessorData(model, primitive.indices, TINYGLTF_TYPE_SCALAR, component_type, count, stride, error) };
+            if (!data)
+            {
+                error = std::format("indices: {}", error);
+                return false;
+            }
+            mesh.indices.resize(count);
+            for (std::size_t i{}; i < count; i++)
+            {
+                switch (component_type)
+                {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: { mesh.indices[i] = data[i * stride]; } break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { std::uint16_t index{}; std::memcpy(&index, data + i * stride, sizeof(index)); mesh.indices[i] = index; } break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: { std::memcpy(&mesh.indices[i], data + i * stride, sizeof(std::uint32_t)); } break;
+                default: { error = "indices have an unsupported component type"; return false; }
+                }
+                if (mesh.indices[i] >= mesh.positions.size())
+                {
+                    error = std::format("index {} is out of range", mesh.indices[i]);
+                    return false;
+                }
+            }
+        }
+        if (mesh.indices.size() % 3 != 0)
+        {
+            error = "index count is not a multiple of 3";
+            return false;
+        }
+        return true;
+    }
+    std::size_t MeshFileSize(const MeshData& mesh)
+    {
+        std::size_t index_size{ MeshIndexType(mesh) == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t) };
+        std::size_t vertex_offset{ AlignUp(sizeof(MeshFileHeader), MESH_FILE_ALIGNMENT) };
+        std::size_t index_offset{ AlignUp(vertex_offset + mesh.positions.size() * sizeof(PackedVertex), MESH_FILE_ALIGNMENT) };
+        return index_offset + mesh.indices.size() * index_size;
+    }
+    std::vector<std::byte> EncodeMeshFile(const MeshData& mesh)
+    {
+        gltk_Check(mesh.positions.size() <= std::numeric_limits<std::uint32_t>::max());
+        gltk_Check(mesh.normals.empty() || mesh.normals.size() == mesh.positions.size());
+        gltk_Check(mesh.uvs.empty() || mesh.uvs.size() == mesh.positions.size());
+
+        MeshFileHeader header{};
+        std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(MESH_FILE_MAGIC));
+        header.vertex_count = static_cast<std::uint32_t>(mesh.positions.size());
+        header.index_count = static_cast<std::uint32_t>(mesh.indices.size());
+        header.index_type = MeshIndexType(mesh);
+        header.vertex_stride = sizeof(PackedVertex);
+        header.vertex_offset = AlignUp(sizeof(MeshFileHeader), MESH_FILE_ALIGNMENT);
+        header.index_offset = AlignUp(header.vertex_offset + mesh.positions.size() * sizeof(PackedVertex), MESH_FILE_ALIGNMENT);
+
+        // uvs are stored relative to their range, so that 16 bits cover it whatever it is
+        glm::vec2 uv_min{ 0.0f };
+        glm::vec2 uv_max{ 1.0f };
+        if (!mesh.uvs.empty())
+        {
+            uv_min = uv_max = mesh.uvs.front();
+            for (const glm::vec2& uv : mesh.uvs)
+            {
+                uv_min = glm::min(uv_min, uv);
+                uv_max = glm::max(uv_max, uv);
+            }
+        }
+        glm::vec2 uv_scale{ glm::max(uv_max - uv_min, glm::vec2{ std::numeric_limits<float>::min() }) };
+        header.uv_offset[0] = uv_min.x;
+        header.uv_offset[1] = uv_min.y;
+        header.uv_scale[0] = uv_scale.x;
+        header.uv_scale[1] = uv_scale.y;
+
+        glm::vec3 position_min{ mesh.positions.empty() ? glm::vec3{} : mesh.positions.front() };
+        glm::vec3 position_max{ position_min };
+        for (const glm::vec3& position : mesh.positions)
+        {
+            position_min = glm::min(position_min, position);
+            position_max = glm::max(position_max, position);
+        }
+        glm::vec3 center{ (position_min + position_max) * 0.5f };
+        float radius{};
+        for (const glm::vec3& position : mesh.positions)
+        {
+            radius = std::max(radius, glm::length(position - center));
+        }
+        header.center[0] = center.x;
+        header.center[1] = center.y;
+        header.center[2] = center.z;
+        header.radius = radius;
+
+        std::vector<std::byte> bytes(MeshFileSize(mesh));
+        std::memcpy(bytes.data(), &header, sizeof(header));
+
+        PackedVertex* vertices{ reinterpret_cast<PackedVertex*>(bytes.data() + header.vertex_offset) };
+        for (std::size_t v{}; v < mesh.positions.size(); v++)
+        {
+            PackedVertex vertex{};
+            for (int k{}; k < 3; k++)
+            {
+                vertex.position[k] = glm::packHalf1x16(mesh.positions[v][k]);
+            }
+            vertex.position[3] = glm::packHalf1x16(1.0f);
+            if (!mesh.normals.empty())
+            {
+                glm::vec2 normal{ EncodeOctahedral(mesh.normals[v]) };
+                vertex.normal[0] = QuantizeSnorm(normal.x);
+                vertex.normal[1] = QuantizeSnorm(normal.y);
+            }
+            if (!mesh.uvs.empty())
+            {
+                glm::vec2 uv{ (mesh.uvs[v] - uv_min) / uv_scale };
+                vertex.uv[0] = QuantizeUnorm(uv.x);
+                vertex.uv[1] = QuantizeUnorm(uv.y);
+            }
+            std::memcpy(&vertices[v], &vertex, sizeof(vertex));
+        }
+
+        std::byte* indices{ bytes.data() + header.index_offset };
+        for (std::size_t i{}; i < mesh.indices.size(); i++)
+        {
+            if (header.index_type == GL_UNSIGNED_SHORT)
+            {
+                std::uint16_t index{ static_cast<std::uint16_t>(mesh.indices[i]) };
+                std::memcpy(indices + i * sizeof(index), &index, sizeof(index));
+            }
+            else
+            {
+                std::memcpy(indices + i * sizeof(std::uint32_t), &mesh.indices[i], sizeof(std::uint32_t));
+            }
+        }
+        return bytes;
+    }
+    bool WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh)
+    {
+        std::vector<std::byte> bytes{ EncodeMeshFile(mesh) };
+
+        // write next to the final file and rename, so that a crash never leaves a truncated file behind
+        std::filesystem::path tmp_path{ path };
+        tmp_path += ".tmp";
+        {
+            std::ofstream file{ tmp_path, std::ios::binary | std::ios::trunc };
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,411 @@
+#include <gltk/OcclusionCuller.h>
+#include <gltk/Check.h>
+#include <gltk/Frustum.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Profiler.h>
+#include <gltk/ProgramBuilder.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace gltk
+{
+    // the 14 corners of a cube drawn as one triangle strip, picked by the bits of gl_VertexID
+    constexpr const char* PROXY_VERTEX_SHADER_SOURCE{
+        "#version 330 core\n"
+        "uniform mat4 uViewProj;\n"
+        "uniform vec3 uMin;\n"
+        "uniform vec3 uMax;\n"
+        "void main()\n"
+        "{\n"
+        "   uint b = 1u << uint(gl_VertexID);\n"
+        "   vec3 corner = vec3((0x287Au & b) != 0u, (0x02AFu & b) != 0u, (0x31E3u & b) != 0u);\n"
+        "   gl_Position = uViewProj * vec4(mix(uMin, uMax, corner), 1.0);\n"
+        "}\n"
+    };
+    constexpr const char* PROXY_FRAGMENT_SHADER_SOURCE{
+        "#version 330 core\n"
+        "void main()\n"
+        "{\n"
+        "}\n"
+    };
+
+    static std::uint32_t SpreadBits(std::uint32_t v)
+    {
+        v = (v | (v << 16)) & 0x030000FF;
+        v = (v | (v << 8)) & 0x0300F00F;
+        v = (v | (v << 4)) & 0x030C30C3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+    static std::uint32_t MortonCode(const glm::vec3& p, const glm::vec3& min, const glm::vec3& extent)
+    {
+        glm::vec3 q{ glm::clamp((p - min) / glm::max(extent, glm::vec3{ 1e-6f }), 0.0f, 1.0f) * 1023.0f };
+        return (SpreadBits(static_cast<std::uint32_t>(q.x)) << 2) | (SpreadBits(static_cast<std::uint32_t>(q.y)) << 1) | SpreadBits(static_cast<std::uint32_t>(q.z));
+    }
+    static float PlaneDistance(const glm::vec4& plane, const glm::vec3& min, const glm::vec3& max, bool nearest)
+    {
+        // the corner furthest along the plane normal (or the nearest one)
+        glm::bvec3 positive{ glm::greaterThanEqual(glm::vec3{ plane }, glm::vec3{ 0.0f }) };
+        glm::vec3 corner{ nearest ? glm::mix(max, min, glm::vec3{ positive }) : glm::mix(min, max, glm::vec3{ positive }) };
+        return glm::dot(glm::vec3{ plane }, corner) + plane.w;
+    }
+
+    OcclusionCuller::OcclusionCuller()
+        : m_program{}
+        , m_vao{}
+        , m_view_proj_location{}
+        , m_min_location{}
+        , m_max_location{}
+        , m_objects{}
+        , m_groups{}
+        , m_order{}
+        , m_group_order{}
+        , m_group_depth{}
+        , m_object_group{}
+        , m_object_in_frustum{}
+        , m_hierarchy_dirty{}
+        , m_planes{}
+        , m_color_mask{}
+        , m_depth_mask{}
+        , m_cull_face{}
+        , m_stats{}
+    {
+        ProgramBuilder builder{};
+        gltk_Check(builder.Compile(GL_VERTEX_SHADER, PROXY_VERTEX_SHADER_SOURCE));
+        gltk_Check(builder.Compile(GL_FRAGMENT_SHADER, PROXY_FRAGMENT_SHADER_SOURCE));
+        m_program = builder.Link();
+        gltk_Check(m_program);
+        gltk_GLCheck(m_view_proj_location = glGetUniformLocation(m_program, "uViewProj"));
+        gltk_GLCheck(m_min_location = glGetUniformLocation(m_program, "uMin"));
+        gltk_GLCheck(m_max_location = glGetUniformLocation(m_program, "uMax"));
+
+        // the corners come from gl_VertexID, but core profile draws still need a vao
+        gltk_GLCheck(glGenVertexArrays(1, &m_vao));
+    }
+    OcclusionCuller::~OcclusionCuller()
+    {
+        for (const Node& object : m_objects)
+        {
+            gltk_GLCheck(glDeleteQueries(1, &object.query));
+        }
+        for (const Group& group : m_groups)
+        {
+            gltk_GLCheck(glDeleteQueries(1, &group.node.query));
+        }
+        gltk_GLCheck(glDeleteVertexArrays(1, &m_vao));
+        gltk_GLCheck(glDeleteProgram(m_program));
+    }
+    std::uint32_t OcclusionCuller::Add(const glm::vec3& min, const glm::vec3& max)
+    {
+        gltk_Check(glm::all(glm::lessThanEqual(min, max)));
+        Node object{ .min = min, .max = max, .query = 0, .visible = true, .pending = false };
+        gltk_GLCheck(glGenQueries(1, &object.query));
+        m_objects.push_back(object);
+        m_object_group.push_back(0);
+        m_object_in_frustum.push_back(0);
+        m_hierarchy_dirty = true;
+        return ObjectCount() - 1;
+    }
+    void OcclusionCuller::SetBounds(std::uint32_t object, const glm::vec3& min, const glm::vec3& max)
+    {
+        gltk_Check(object < ObjectCount() && glm::all(glm::lessThanEqual(min, max)));
+        m_objects[object].min = min;
+        m_objects[object].max = max;
+        if (!m_hierarchy_dirty)
+        {
+            Group& group{ m_groups[m_object_group[object]] };
+            group.node.min = glm::vec3{ std::numeric_limits<float>::max() };
+            group.node.max = glm::vec3{ std::numeric_limits<float>::lowest() };
+            for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+            {
+                group.node.min = glm::min(group.node.min, m_objects[m_order[i]].min);
+                group.node.max = glm::max(group.node.max, m_objects[m_order[i]].max);
+            }
+        }
+    }
+    void OcclusionCuller::Render(const glm::mat4& view_proj, const std::function<void(std::uint32_t)>& draw)
+    {
+        gltk_ProfileZone("OcclusionCuller::Render");
+        auto start{ std::chrono::steady_clock::now() };
+
+        m_stats = {};
+        if (m_hierarchy_dirty)
+        {
+            BuildHierarchy();
+        }
+        m_stats.objects = static_cast<int>(ObjectCount());
+        m_stats.groups = static_cast<int>(m_groups.size());
+
+        ExtractFrustumPlanes(view_proj, m_planes); // normalized, so the near plane measures depth
+
+        ReadResults();
+
+        for (std::uint32_t group{}; group < m_groups.size(); group++)
+        {
+            m_group_depth[group] = PlaneDistance(m_planes[4], m_groups[group].node.min, m_groups[group].node.max, true);
+        }
+        std::ranges::sort(m_group_order, [this](std::uint32_t a, std::uint32_t b) { return m_group_depth[a] < m_group_depth[b]; });
+
+        gltk_GLCheck(glGetBooleanv(GL_COLOR_WRITEMASK, m_color_mask));
+        gltk_GLCheck(glGetBooleanv(GL_DEPTH_WRITEMASK, &m_depth_mask));
+        gltk_GLCheck(m_cull_face = glIsEnabled(GL_CULL_FACE));
+        gltk_GLCheck(glUseProgram(m_program));
+        gltk_GLCheck(glUniformMatrix4fv(m_view_proj_location, 1, GL_FALSE, &view_proj[0][0]));
+
+        for (std::uint32_t group : m_group_order)
+        {
+            RenderGroup(m_groups[group], draw);
+        }
+
+        m_stats.cpu_time = std::chrono::steady_clock::now() - start;
+    }
+    void OcclusionCuller::BuildHierarchy()
+    {
+        for (const Group& group : m_groups)
+        {
+            gltk_GLCheck(glDeleteQueries(1, &group.node.query));
+        }
+        m_groups.clear();
+
+        glm::vec3 min{ std::numeric_limits<float>::max() };
+        glm::vec3 max{ std::numeric_limits<float>::lowest() };
+        for (const Node& object : m_objects)
+        {
+            min = glm::min(min, 0.5f * (object.min + object.max));
+            max = glm::max(max, 0.5f * (object.min + object.max));
+        }
+        std::vector<std::uint32_t> codes(m_objects.size());
+        for (std::uint32_t i{}; i < ObjectCount(); i++)
+        {
+            codes[i] = MortonCode(0.5f * (m_objects[i].min + m_objects[i].max), min, max - min);
+        }
+        m_order.resize(m_objects.size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+        std::ranges::sort(m_order, [&codes](std::uint32_t a, std::uint32_t b) { return codes[a] < codes[b]; });
+
+        for (std::uint32_t first{}; first < ObjectCount(); first += GROUP_SIZE)
+        {
+            Group group{ .node = { .min = glm::vec3{ std::numeric_limits<float>::max() }, .max = glm::vec3{ std::numeric_limits<float>::lowest() },
+                .query = 0, .visible = true, .pending = false }, .first = first, .count = std::min(GROUP_SIZE, ObjectCount() - first) };
+            for (std::uint32_t i{ first }; i < first + group.count; i++)
+            {
+                group.node.min = glm::min(group.node.min, m_objects[m_order[i]].min);
+                group.node.max = glm::max(group.node.max, m_objects[m_order[i]].max);
+                m_object_group[m_order[i]] = static_cast<std::uint32_t>(m_groups.size());
+            }
+            gltk_GLCheck(glGenQueries(1, &group.node.query));
+            m_groups.push_back(group);
+        }
+
+        m_group_order.resize(m_groups.size());
+        std::iota(m_group_order.begin(), m_group_order.end(), 0);
+        m_group_depth.resize(m_groups.size());
+        m_hierarchy_dirty = false;
+    }
+    void OcclusionCuller::ReadResults()
+    {
+        // never blocks: a result that is not there yet is looked at again next frame
+        auto read{ [this](Node& node)
+        {
+            if (!node.pending)
+            {
+                return false;
+            }
+            GLuint available{};
+            gltk_GLCheck(glGetQueryObjectuiv(node.query, GL_QUERY_RESULT_AVAILABLE, &available));
+            if (!available)
+            {
+                m_stats.queries_pending++;
+                return false;
+            }
+            GLuint samples_passed{};
+            gltk_GLCheck(glGetQueryObjectuiv(node.query, GL_QUERY_RESULT, &samples_passed));
+            node.visible = samples_passed != 0;
+            node.pending = false;
+            m_stats.results_read++;
+            return true;
+        } };
+
+        for (Node& object : m_objects)
+        {
+            read(object);
+        }
+        for (Group& group : m_groups)
+        {
+            if (read(group.node) && group.node.visible)
+            {
+                // something in the group shows: its objects are drawn and tested on their own from now on
+                for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+                {
+                    m_objects[m_order[i]].visible = true;
+                }
+            }
+            else if (group.node.visible && !group.node.pending)
+            {
+                // every object hidden: one box tests them all until one of them shows again
+                bool hidden{ true };
+                for (std::uint32_t i{ group.first }; i < group.first + group.count && hidden; i++)
+                {
+                    hidden = !m_objects[m_order[i]].visible && !m_objects[m_order[i]].pending;
+                }
+                group.node.visible = !hidden;
+            }
+        }
+    }
+    void OcclusionCuller::RenderGroup(Group& group, const std::function<void(std::uint32_t)>& draw)
+    {
+        Node& node{ group.node };
+        if (!InFrustum(node))
+        {
+            m_stats.frustum_culled += static_cast<int>(group.count);
+            return;
+        }
+
+        // 0 outside the frustum, 1 inside, 2 inside and tested with its box this frame
+        for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+        {
+            std::uint32_t object{ m_order[i] };
+            m_object_in_frustum[object] = InFrustum(m_objects[object]);
+            m_stats.frustum_culled += !m_object_in_frustum[object];
+        }
+
+        if (!node.visible && node.pending)
+        {
+            // hidden group with a late result: no test to go by, draw what the frustum lets through
+            for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+            {
+                if (m_object_in_frustum[m_order[i]])
+                {
+                    draw(m_order[i]);
+                    m_stats.drawn++;
+                }
+            }
+            return;
+        }
+        if (!node.visible && BeyondNearPlane(node))
+        {
+            BeginProxies();
+            gltk_GLCheck(glBeginQuery(GL_ANY_SAMPLES_PASSED, node.query));
+            DrawProxy(node);
+            gltk_GLCheck(glEndQuery(GL_ANY_SAMPLES_PASSED));
+            EndProxies();
+            node.pending = true;
+            m_stats.queries++;
+            m_stats.proxy_queries++;
+            m_stats.group_queries++;
+
+            gltk_GLCheck(glBeginConditionalRender(node.query, GL_QUERY_WAIT));
+            for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+            {
+                if (m_object_in_frustum[m_order[i]])
+                {
+                    draw(m_order[i]);
+                    m_stats.occluded++;
+                }
+            }
+            gltk_GLCheck(glEndConditionalRender());
+            return;
+        }
+        node.visible = true; // a hidden group that crosses the near plane is looked at object by object
+
+        // boxes of the hidden objects first, to switch the write masks once
+        bool proxies{};
+        for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+        {
+            std::uint32_t object{ m_order[i] };
+            Node& object_node{ m_objects[object] };
+            if (m_object_in_frustum[object] && !object_node.visible && !object_node.pending && BeyondNearPlane(object_node))
+            {
+                if (!proxies)
+                {
+                    BeginProxies();
+                    proxies = true;
+                }
+                gltk_GLCheck(glBeginQuery(GL_ANY_SAMPLES_PASSED, object_node.query));
+                DrawProxy(object_node);
+                gltk_GLCheck(glEndQuery(GL_ANY_SAMPLES_PASSED));
+                object_node.pending = true;
+                m_object_in_frustum[object] = 2;
+                m_stats.queries++;
+                m_stats.proxy_queries++;
+            }
+        }
+        if (proxies)
+        {
+            EndProxies();
+        }
+
+        for (std::uint32_t i{ group.first }; i < group.first + group.count; i++)
+        {
+            std::uint32_t object{ m_order[i] };
+            Node& object_node{ m_objects[object] };
+            if (m_object_in_frustum[object] == 2)
+            {
+                gltk_GLCheck(glBeginConditionalRender(object_node.query, GL_QUERY_WAIT));
+                draw(object);
+                gltk_GLCheck(glEndConditionalRender());
+                m_stats.occluded++;
+            }
+            else if (m_object_in_frustum[object] && object_node.pending)
+            {
+                draw(object);
+                m_stats.drawn++;
+            }
+            else if (m_object_in_frustum[object])
+            {
+                // the object itself is the test, its samples keep it visible
+                gltk_GLCheck(glBeginQuery(GL_ANY_SAMPLES_PASSED, object_node.query));
+                draw(object);
+                gltk_GLCheck(glEndQuery(GL_ANY_SAMPLES_PASSED));
+                object_node.pending = true;
+                m_stats.queries++;
+                m_stats.drawn++;
+            }
+        }
+    }
+    void OcclusionCuller::DrawProxy(const Node& node)
+    {
+        gltk_GLCheck(glUniform3fv(m_min_location, 1, &node.min[0]));
+        gltk_GLCheck(glUniform3fv(m_max_location, 1, &node.max[0]));
+        gltk_GLCheck(glDrawArrays(GL_TRIANGLE_STRIP, 0, 14));
+    }
+    void OcclusionCuller::BeginProxies()
+    {
+        // the draw callback may have bound anything since the last boxes
+        gltk_GLCheck(glUseProgram(m_program));
+        gltk_GLCheck(glBindVertexArray(m_vao));
+        gltk_GLCheck(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+        gltk_GLCheck(glDepthMask(GL_FALSE));
+        if (m_cull_face)
+        {
+            gltk_GLCheck(glDisable(GL_CULL_FACE));
+        }
+    }
+    void OcclusionCuller::EndProxies()
+    {
+        gltk_GLCheck(glColorMask(m_color_mask[0], m_color_mask[1], m_color_mask[2], m_color_mask[3]));
+        gltk_GLCheck(glDepthMask(m_depth_mask));
+        if (m_cull_face)
+        {
+            gltk_GLCheck(glEnable(GL_CULL_FACE));
+        }
+    }
+    bool OcclusionCuller::InFrustum(const Node& node) const
+    {
+        for (const glm::vec4& plane : m_planes)
+        {
+            if (PlaneDistance(plane, node.min, node.max, false) < 0.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool OcclusionCuller::BeyondNearPlane(const Node& node) const
+    {
+        // a box reaching in front of the near plane gets clipped, and could fail its query while covering the view
+        return PlaneDistance(m_planes[4], node.min, node.max, true) > 0.0f;
+    }
+}
@@ -0,0 +1,254 @@
+#include <gltk/Profiler.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <string>
+
+namespace gltk
+{
+    static std::string EscapeJson(const char* str)
+    {
+        std::string escaped{};
+        for (; *str; str++)
+        {
+            switch (*str)
+            {
+            case '"': { escaped += "\\\""; } break;
+            case '\\': { escaped += "\\\\"; } break;
+            default: { escaped += *str; } break;
+            }
+        }
+        return escaped;
+    }
+
+    static ImU32 ZoneColor(const char* name)
+    {
+        // stable color per zone name
+        std::uint32_t hash{ 2166136261u };
+        for (; *name; name++)
+        {
+            hash = (hash ^ static_cast<unsigned char>(*name)) * 16777619u;
+        }
+        return IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255);
+    }
+
+    Profiler::Profiler()
+        : m_epoch_ns{}
+        , m_frames{}
+        , m_frame{}
+        , m_in_frame{}
+        , m_stack{}
+        , m_last_frame{}
+        , m_history{}
+        , m_dropped_frames{}
+    {
+        gltk_Check(!s_current);
+        m_epoch_ns = Now();
+        s_current = this;
+    }
+    Profiler::~Profiler()
+    {
+        for (Frame& frame : m_frames)
+        {
+            if (!frame.queries.empty())
+            {
+                gltk_GLCheck(glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data()));
+            }
+        }
+        s_current = nullptr;
+    }
+    void Profiler::BeginFrame()
+    {
+        gltk_Check(!m_in_frame);
+
+        // reuse the slot of FRAME_LATENCY frames ago, harvesting its results first
+        Frame& frame{ m_frames[m_frame % FRAME_LATENCY] };
+        if (frame.pending)
+        {
+            Resolve(frame);
+        }
+
+        frame.zones.clear();
+        frame.used_queries = 0;
+        frame.pending = false;
+        frame.begin_ns = Now() - m_epoch_ns;
+        m_stack.clear();
+        m_in_frame = true;
+
+        BeginZone("Frame");
+    }
+    void Profiler::EndFrame()
+    {
+        gltk_Check(m_in_frame && m_stack.size() == 1);
+        EndZone(m_stack.back());
+
+        m_frames[m_frame % FRAME_LATENCY].pending = true;
+        m_frame++;
+        m_in_frame = false;
+    }
+    int Profiler::BeginZone(const char* name)
+    {
+        if (!m_in_frame)
+        {
+            return -1;
+        }
+
+        Frame& frame{ m_frames[m_frame % FRAME_LATENCY] };
+        if (frame.used_queries + 2 > static_cast<int>(frame.queries.size()))
+        {
+            std::size_t old_size{ frame.queries.size() };
+            frame.queries.resize(old_size + QUERY_CHUNK);
+            gltk_GLCheck(glGenQueries(QUERY_CHUNK, frame.queries.data() + old_size));
+        }
+
+        ProfileZone zone{};
+        zone.name = name;
+        zone.parent = m_stack.empty() ? -1 : m_stack.back();
+        zone.depth = static_cast<int>(m_stack.size());
+        zone.query = frame.used_queries;
+        frame.used_queries += 2;
+        gltk_GLCheck(glQueryCounter(frame.queries[zone.query], GL_TIMESTAMP));
+        zone.cpu_begin_ns = Now() - m_epoch_ns - frame.begin_ns;
+
+        int idx{ static_cast<int>(frame.zones.size()) };
+        frame.zones.push_back(zone);
+        m_stack.push_back(idx);
+        return idx;
+    }
+    void Profiler::EndZone(int zone)
+    {
+        if (!m_in_frame)
+        {
+            return;
+        }
+
+        gltk_Check(!m_stack.empty() && m_stack.back() == zone); // zones must nest
+        m_stack.pop_back();
+
+        Frame& frame{ m_frames[m_frame % FRAME_LATENCY] };
+        ProfileZone& z{ frame.zones[zone] };
+        z.cpu_end_ns = Now() - m_epoch_ns - frame.begin_ns;
+        gltk_GLCheck(glQueryCounter(frame.queries[z.query + 1], GL_TIMESTAMP));
+    }
+    void Profiler::DrawImGui()
+    {
+        if (m_last_frame.empty())
+        {
+            ImGui::TextUnformatted("no frame resolved yet");
+            return;
+        }
+
+        const ProfileZone& root{ m_last_frame.front() };
+        double cpu_ms{ (root.cpu_end_ns - root.cpu_begin_ns) / 1e6 };
+        double gpu_ms{ (root.gpu_end_ns - root.gpu_begin_ns) / 1e6 };
+        ImGui::Text("cpu: %.3f ms, gpu: %.3f ms, dropped frames: %d", cpu_ms, gpu_ms, m_dropped_frames);
+        if (ImGui::Button("Export Chrome trace"))
+        {
+            ExportChromeTrace("gltk_trace.json");
+        }
+
+        // one flame graph per timeline, both scaled to the longer of the two
+        int max_depth{};
+        for (const ProfileZone& zone : m_last_frame)
+        {
+            max_depth = std::max(max_depth, zone.depth);
+        }
+        float row_h{ ImGui::GetTextLineHeightWithSpacing() };
+        float width{ std::max(ImGui::GetContentRegionAvail().x, 1.0f) };
+        double span_ns{ static_cast<double>(std::max({ root.cpu_end_ns - root.cpu_begin_ns, root.gpu_end_ns - root.gpu_begin_ns, std::int64_t{ 1 } })) };
+        double scale{ width / span_ns };
+
+        ImDrawList* draw_list{ ImGui::GetWindowDrawList() };
+        for (bool gpu : { false, true })
+        {
+            ImGui::TextUnformatted(gpu ? "GPU" : "CPU");
+            ImVec2 origin{ ImGui::GetCursorScreenPos() };
+            for (const ProfileZone& zone : m_last_frame)
+            {
+                std::int64_t begin_ns{ gpu ? zone.gpu_begin_ns : zone.cpu_begin_ns };
+                std::int64_t end_ns{ gpu ? zone.gpu_end_ns : zone.cpu_end_ns };
+                ImVec2 min{ origin.x + static_cast<float>(begin_ns * scale), origin.y + zone.depth * row_h };
+                ImVec2 max{ origin.x + static_cast<float>(end_ns * scale), min.y + row_h - 1.0f };
+                max.x = std::max(max.x, min.x + 1.0f);
+                draw_list->AddRectFilled(min, max, ZoneColor(zone.name));
+                ImVec4 clip{ min.x, min.y, max.x, max.y };
+                draw_list->AddText(nullptr, 0.0f, ImVec2{ min.x + 2.0f, min.y }, IM_COL32_WHITE, zone.name, nullptr, 0.0f, &clip);
+                if (ImGui::IsMouseHoveringRect(min, max))
+                {
+                    ImGui::SetTooltip("%s: %.3f ms", zone.name, (end_ns - begin_ns) / 1e6);
+                }
+            }
+            ImGui::Dummy(ImVec2{ width, (max_depth + 1) * row_h });
+        }
+    }
+    bool Profiler::ExportChromeTrace(const std::filesystem::path& path) const
+    {
+        std::ofstream file{ path };
+        if (!file)
+        {
+            return false;
+        }
+
+        // complete events ("ph":"X") in microseconds, CPU zones on tid 0 and GPU zones on tid 1
+        file << "{\"traceEvents\":[\n";
+        bool first{ true };
+        for (const ResolvedFrame& frame : m_history)
+        {
+            for (const ProfileZone& zone : frame.zones)
+            {
+                std::string name{ EscapeJson(zone.name) };
+                file << std::format("{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    first ? "" : ",\n", name, (frame.begin_ns + zone.cpu_begin_ns) / 1e3, (zone.cpu_end_ns - zone.cpu_begin_ns) / 1e3);
+                file << std::format(",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":1,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    name, (frame.begin_ns + zone.gpu_begin_ns) / 1e3, (zone.gpu_end_ns - zone.gpu_begin_ns) / 1e3);
+                first = false;
+            }
+        }
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        return static_cast<bool>(file);
+    }
+    std::int64_t Profiler::Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void Profiler::Resolve(Frame& frame)
+    {
+        // queries complete in order, so the last one issued being available means all of them are: that is the end
+        // of the root zone, written by EndFrame after every other zone has ended
+        int available{};
+        gltk_GLCheck(glGetQueryObjectiv(frame.queries[frame.zones[0].query + 1], GL_QUERY_RESULT_AVAILABLE, &available));
+        if (!available)
+        {
+            m_dropped_frames++;
+            return;
+        }
+
+        GLuint64 gpu_epoch{};
+        for (ProfileZone& zone : frame.zones)
+        {
+            GLuint64 begin{};
+            GLuint64 end{};
+            gltk_GLCheck(glGetQueryObjectui64v(frame.queries[zone.query], GL_QUERY_RESULT, &begin));
+            gltk_GLCheck(glGetQueryObjectui64v(frame.queries[zone.query + 1], GL_QUERY_RESULT, &end));
+            if (zone.parent < 0)
+            {
+                gpu_epoch = begin;
+            }
+            zone.gpu_begin_ns = static_cast<std::int64_t>(begin - gpu_epoch);
+            zone.gpu_end_ns = static_cast<std::int64_t>(end - gpu_epoch);
+        }
+
+        m_last_frame = frame.zones;
+        m_history.push_back({ frame.begin_ns, frame.zones });
+        if (m_history.size() > MAX_HISTORY_FRAMES)
+        {
+            m_history.pop_front();
+        }
+    }
+}
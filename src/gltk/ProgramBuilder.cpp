@@ -4,6 +4,8 @@
 
 #include <scope_guard.hpp>
 
+#include <chrono>
+
 namespace gltk
 {
     int ProgramBuilder::GetShaderTypeIdx(GLenum shader_type)
@@ -33,9 +35,15 @@ namespace gltk
         return shader_type;
     }
     ProgramBuilder::ProgramBuilder()
+        : ProgramBuilder{ nullptr }
+    {
+    }
+    ProgramBuilder::ProgramBuilder(ProgramCache* cache)
         : m_status{}
         , m_info_log{}
         , m_shader{}
+        , m_cache{ cache }
+        , m_source{}
     {
     }
     ProgramBuilder::~ProgramBuilder()
@@ -54,6 +62,48 @@ namespace gltk
     {
         int shader_idx{ GetShaderTypeIdx(shader_type) };
 
+        if (m_cache && m_cache->Enabled())
+        {
+            std::string& src{ m_source[shader_idx] };
+            src.clear();
+            for (GLsizei i{}; i < count; i++)
+            {
+                if (line_lengths && line_lengths[i] >= 0)
+                {
+                    src.append(lines[i], line_lengths[i]);
+                }
+                else
+                {
+                    src.append(lines[i]);
+                }
+            }
+            return true;
+        }
+
+        return CompileShader(shader_idx, count, lines, line_lengths);
+    }
+    GLuint ProgramBuilder::Link()
+    {
+        if (m_cache && m_cache->Enabled())
+        {
+            return LinkCached();
+        }
+        return LinkShaders(false);
+    }
+    void ProgramBuilder::Delete(GLenum shader_type)
+    {
+        int shader_idx{ GetShaderTypeIdx(shader_type) };
+        if (m_shader[shader_idx])
+        {
+            gltk_GLCheck(glDeleteShader(m_shader[shader_idx]));
+            m_shader[shader_idx] = 0;
+        }
+        m_source[shader_idx].clear();
+    }
+    bool ProgramBuilder::CompileShader(int shader_idx, GLsizei count, const GLchar** lines, const GLint* line_lengths)
+    {
+        GLenum shader_type{ GetShaderType(shader_idx) };
+
         if (!m_shader[shader_idx])
         {
             gltk_GLCheck(m_shader[shader_idx] = glCreateShader(shader_type));
@@ -70,7 +120,7 @@ namespace gltk
         }
         return success;
     }
-    GLuint ProgramBuilder::Link()
+    GLuint ProgramBuilder::LinkShaders(bool retrievable)
     {
         GLuint program{};
         gltk_GLCheck(program = glCreateProgram());
@@ -83,6 +133,10 @@ namespace gltk
                 gltk_GLCheck(glAttachShader(program, m_shader[i]));
             }
         }
+        if (retrievable)
+        {
+            gltk_GLCheck(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
         gltk_GLCheck(glLinkProgram(program));
 
         int success{ false };
@@ -98,13 +152,33 @@ namespace gltk
             return 0;
         }
     }
-    void ProgramBuilder::Delete(GLenum shader_type)
+    GLuint ProgramBuilder::LinkCached()
     {
-        int shader_idx{ GetShaderTypeIdx(shader_type) };
-        if (m_shader[shader_idx])
+        std::uint64_t key{ m_cache->Key(m_source) };
+        if (GLuint program{ m_cache->Load(key) })
         {
-            gltk_GLCheck(glDeleteShader(m_shader[shader_idx]));
-            m_shader[shader_idx] = 0;
+            return program;
+        }
+
+        auto start{ std::chrono::steady_clock::now() };
+        for (int i{}; i < MAX_SHADER_INDEX; i++)
+        {
+            if (!m_source[i].empty())
+            {
+                const GLchar* src{ m_source[i].c_str() };
+                GLint src_length{ static_cast<GLint>(m_source[i].size()) };
+                if (!CompileShader(i, 1, &src, &src_length))
+                {
+                    return 0;
+                }
+            }
+        }
+
+        GLuint program{ LinkShaders(true) };
+        if (program)
+        {
+            m_cache->Store(key, program, std::chrono::steady_clock::now() - start);
         }
+        return program;
     }
 }
@@ -0,0 +1,189 @@
+#include <gltk/ProgramCache.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Hash.h>
+
+#include <scope_guard.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace gltk
+{
+    namespace
+    {
+        constexpr char ENTRY_MAGIC[8]{ 'G', 'L', 'T', 'K', 'P', 'B', '0', '1' };
+
+        struct EntryHeader
+        {
+            char magic[8];
+            std::uint64_t key;
+            std::uint32_t format;
+            std::uint32_t length;
+            std::int64_t build_ns;
+        };
+
+        std::string GetGLString(GLenum name)
+        {
+            const GLubyte* str{};
+            gltk_GLCheck(str = glGetString(name));
+            return str ? reinterpret_cast<const char*>(str) : "";
+        }
+    }
+
+    ProgramCache::ProgramCache(const std::filesystem::path& dir)
+        : m_enabled{}
+        , m_dir{ dir }
+        , m_driver{}
+        , m_stats{}
+    {
+        if (!GLAD_GL_ARB_get_program_binary)
+        {
+            return;
+        }
+
+        int format_count{};
+        gltk_GLCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count));
+        if (format_count <= 0)
+        {
+            return;
+        }
+
+        std::error_code ec{};
+        std::filesystem::create_directories(m_dir, ec);
+        if (ec)
+        {
+            return;
+        }
+
+        m_driver = std::format("{}\n{}\n{}", GetGLString(GL_VENDOR), GetGLString(GL_RENDERER), GetGLString(GL_VERSION));
+        m_enabled = true;
+    }
+    std::uint64_t ProgramCache::Key(std::span<const std::string> stage_sources) const
+    {
+        std::uint64_t hash{ HashBytes(FNV_OFFSET_BASIS, m_driver.data(), m_driver.size()) };
+        for (const std::string& src : stage_sources)
+        {
+            // hash the length too, so that moving text between stages changes the key
+            std::uint64_t size{ src.size() };
+            hash = HashBytes(hash, &size, sizeof(size));
+            hash = HashBytes(hash, src.data(), src.size());
+        }
+        return hash;
+    }
+    GLuint ProgramCache::Load(std::uint64_t key)
+    {
+        if (!m_enabled)
+        {
+            return 0;
+        }
+
+        // the length comes from disk, so it is checked against the file before allocating for it
+        std::filesystem::path path{ EntryPath(key) };
+        std::error_code ec{};
+        std::uintmax_t file_size{ std::filesystem::file_size(path, ec) };
+        std::ifstream file{ path, std::ios::binary };
+        EntryHeader header{};
+        if (ec || !file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0 || header.key != key
+            || file_size != sizeof(header) + header.length)
+        {
+            m_stats.misses++;
+            return 0;
+        }
+
+        std::vector<char> binary(header.length);
+        if (!file.read(binary.data(), binary.size()))
+        {
+            m_stats.misses++;
+            return 0;
+        }
+        file.close();
+
+        auto start{ std::chrono::steady_clock::now() };
+
+        GLuint program{};
+        gltk_GLCheck(program = glCreateProgram());
+        auto delete_program_on_exit{ sg::make_scope_guard([=]() { glDeleteProgram(program); }) };
+
+        // a driver may refuse a binary it produced itself (e.g. after an update that kept the version string),
+        // in which case the program is left unlinked and the entry gets rewritten by the caller
+        gltk_GLCheck(glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size())));
+
+        int success{ false };
+        gltk_GLCheck(glGetProgramiv(program, GL_LINK_STATUS, &success));
+        if (!success)
+        {
+            std::filesystem::remove(path, ec);
+            m_stats.rejects++;
+            m_stats.misses++;
+            return 0;
+        }
+
+        std::chrono::nanoseconds load_time{ std::chrono::steady_clock::now() - start };
+        m_stats.hits++;
+        m_stats.time_saved += std::max(std::chrono::nanoseconds{ header.build_ns } - load_time, std::chrono::nanoseconds{});
+
+        delete_program_on_exit.dismiss();
+        return program;
+    }
+    void ProgramCache::Store(std::uint64_t key, GLuint program, std::chrono::nanoseconds build_time)
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        int length{};
+        gltk_GLCheck(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+        if (length <= 0)
+        {
+            return;
+        }
+
+        EntryHeader header{};
+        std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+        header.key = key;
+        header.build_ns = build_time.count();
+
+        std::vector<char> binary(length);
+        GLenum format{};
+        GLsizei written{};
+        gltk_GLCheck(glGetProgramBinary(program, length, &written, &format, binary.data()));
+        if (written <= 0)
+        {
+            return;
+        }
+        header.format = format;
+        header.length = static_cast<std::uint32_t>(written);
+
+        // write next to the final entry and rename, so that a crash never leaves a truncated entry behind
+        std::filesystem::path path{ EntryPath(key) };
+        std::filesystem::path tmp_path{ path };
+        tmp_path += ".tmp";
+        {
+            std::ofstream file{ tmp_path, std::ios::binary | std::ios::trunc };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), header.length);
+            if (!file)
+            {
+                return;
+            }
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return;
+        }
+        m_stats.writes++;
+    }
+    std::filesystem::path ProgramCache::EntryPath(std::uint64_t key) const
+    {
+        return m_dir / std::format("{:016x}.bin", key);
+    }
+}
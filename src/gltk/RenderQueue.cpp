@@ -0,0 +1,209 @@
+#include <gltk/RenderQueue.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Profiler.h>
+
+#include <algorithm>
+#include <tuple>
+
+namespace gltk
+{
+    static auto GeometryTuple(const DrawItem& item)
+    {
+        return std::tuple{ item.mode, item.index_type, item.count, item.first, item.base_vertex };
+    }
+
+    static std::uint16_t DenseId(std::unordered_map<GLuint, std::uint16_t>& ids, GLuint name)
+    {
+        auto [it, inserted] { ids.try_emplace(name, static_cast<std::uint16_t>(ids.size())) };
+        gltk_Check(!inserted || ids.size() <= 0x10000); // distinct programs or vaos in one flush
+        return it->second;
+    }
+
+    std::uint64_t RenderQueue::SortKey(const DrawItem& item)
+    {
+        // program | vao | material | depth, 16 bits each; GL names can be anything, so the key holds dense ids
+        float depth{ std::clamp(item.depth, 0.0f, 1.0f) };
+        std::uint64_t key{};
+        key |= static_cast<std::uint64_t>(DenseId(m_program_ids, item.program)) << 48;
+        key |= static_cast<std::uint64_t>(DenseId(m_vao_ids, item.vao)) << 32;
+        key |= static_cast<std::uint64_t>(item.material) << 16;
+        key |= static_cast<std::uint64_t>(depth * 0xFFFF);
+        return key;
+    }
+    RenderQueue::RenderQueue(GLsizeiptr instance_buffer_size)
+        : m_state{}
+        , m_instances{ GL_ARRAY_BUFFER, instance_buffer_size }
+        , m_materials{}
+        , m_items{}
+        , m_keys{}
+        , m_program_ids{}
+        , m_vao_ids{}
+        , m_run{}
+        , m_counts{}
+        , m_firsts{}
+        , m_offsets{}
+        , m_base_vertices{}
+        , m_stats{}
+    {
+        m_materials.push_back({}); // material 0 binds no textures
+    }
+    std::uint16_t RenderQueue::AddMaterial(const Material& material)
+    {
+        gltk_Check(m_materials.size() <= 0xFFFF);
+        m_materials.push_back(material);
+        return static_cast<std::uint16_t>(m_materials.size() - 1);
+    }
+    void RenderQueue::Submit(const DrawItem& item)
+    {
+        gltk_Check(item.material < m_materials.size());
+        m_items.push_back(item);
+    }
+    void RenderQueue::Flush()
+    {
+        gltk_ProfileZone("RenderQueue::Flush");
+
+        m_stats = {};
+        m_stats.items = static_cast<int>(m_items.size());
+
+        // whatever ran since the last flush (e.g. imgui) may have changed the bindings
+        m_state.Invalidate();
+        m_state.ResetStats();
+
+        m_keys.clear();
+        m_program_ids.clear();
+        m_vao_ids.clear();
+        for (std::uint32_t i{}; i < m_items.size(); i++)
+        {
+            m_keys.push_back({ SortKey(m_items[i]), i });
+        }
+        std::sort(m_keys.begin(), m_keys.end());
+
+        for (std::size_t begin{}; begin < m_keys.size();)
+        {
+            // run of items sharing program, vao and material
+            std::uint64_t state_key{ m_keys[begin].first >> 16 };
+            std::size_t end{ begin };
+            m_run.clear();
+            while (end < m_keys.size() && (m_keys[end].first >> 16) == state_key)
+            {
+                m_run.push_back(&m_items[m_keys[end].second]);
+                end++;
+            }
+            begin = end;
+
+            BindState(*m_run.front());
+
+            auto plain_begin{ std::stable_partition(m_run.begin(), m_run.end(), [](const DrawItem* item) { return item->instance != NO_INSTANCE; }) };
+            std::stable_sort(m_run.begin(), plain_begin, [](const DrawItem* a, const DrawItem* b) { return GeometryTuple(*a) < GeometryTuple(*b); });
+            std::stable_sort(plain_begin, m_run.end(), [](const DrawItem* a, const DrawItem* b) { return std::tuple{ a->mode, a->index_type } < std::tuple{ b->mode, b->index_type }; });
+
+            for (auto it{ m_run.begin() }; it != plain_begin;)
+            {
+                auto group_end{ std::find_if(it, plain_begin, [&](const DrawItem* item) { return GeometryTuple(*item) != GeometryTuple(**it); }) };
+                DrawInstanced(&*it, static_cast<int>(group_end - it));
+                it = group_end;
+            }
+            for (auto it{ plain_begin }; it != m_run.end();)
+            {
+                auto group_end{ std::find_if(it, m_run.end(), [&](const DrawItem* item) { return item->mode != (*it)->mode || item->index_type != (*it)->index_type; }) };
+                DrawMulti(&*it, static_cast<int>(group_end - it));
+                it = group_end;
+            }
+        }
+
+        m_stats.state_changes = m_state.Stats().binds;
+        m_stats.binds_avoided = m_state.Stats().binds_avoided;
+        m_stats.texture_binds = m_state.Stats().texture_binds;
+
+        m_items.clear();
+        m_instances.EndFrame();
+    }
+    void RenderQueue::BindState(const DrawItem& item)
+    {
+        m_state.UseProgram(item.program);
+        m_state.BindVertexArray(item.vao);
+        const Material& material{ m_materials[item.material] };
+        for (int unit{}; unit < static_cast<int>(std::size(material.textures)); unit++)
+        {
+            if (material.textures[unit])
+            {
+                m_state.BindTexture(unit, material.target, material.textures[unit]);
+            }
+        }
+    }
+    void RenderQueue::DrawInstanced(const DrawItem* const* items, int count)
+    {
+        StreamRange range{ m_instances.Map(count * sizeof(std::uint32_t), sizeof(std::uint32_t)) };
+        std::uint32_t* instances{ static_cast<std::uint32_t*>(range.data) };
+        for (int i{}; i < count; i++)
+        {
+            instances[i] = items[i]->instance;
+        }
+        m_instances.Unmap(range);
+
+        if (!m_instances.Persistent())
+        {
+            m_state.InvalidateArrayBuffer(); // mapping binds the buffer and leaves GL_ARRAY_BUFFER unbound
+        }
+        m_state.BindArrayBuffer(m_instances.Buffer());
+        gltk_GLCheck(glEnableVertexAttribArray(INSTANCE_ATTRIB));
+        gltk_GLCheck(glVertexAttribIPointer(INSTANCE_ATTRIB, 1, GL_UNSIGNED_INT, 0, reinterpret_cast<const void*>(range.offset)));
+        gltk_GLCheck(glVertexAttribDivisor(INSTANCE_ATTRIB, 1));
+
+        const DrawItem& item{ *items[0] };
+        if (item.index_type == GL_NONE)
+        {
+            gltk_GLCheck(glDrawArraysInstanced(item.mode, static_cast<GLint>(item.first), item.count, count));
+        }
+        else
+        {
+            gltk_GLCheck(glDrawElementsInstancedBaseVertex(item.mode, item.count, item.index_type, reinterpret_cast<const void*>(item.first), count, item.base_vertex));
+        }
+        // the vao belongs to the caller, a later draw with it outside the queue must not fetch the instance attribute
+        gltk_GLCheck(glVertexAttribDivisor(INSTANCE_ATTRIB, 0));
+        gltk_GLCheck(glDisableVertexAttribArray(INSTANCE_ATTRIB));
+        m_stats.draw_calls++;
+        m_stats.instanced_draws++;
+    }
+    void RenderQueue::DrawMulti(const DrawItem* const* items, int count)
+    {
+        const DrawItem& item{ *items[0] };
+        if (count == 1)
+        {
+            if (item.index_type == GL_NONE)
+            {
+                gltk_GLCheck(glDrawArrays(item.mode, static_cast<GLint>(item.first), item.count));
+            }
+            else
+            {
+                gltk_GLCheck(glDrawElementsBaseVertex(item.mode, item.count, item.index_type, reinterpret_cast<const void*>(item.first), item.base_vertex));
+            }
+            m_stats.draw_calls++;
+            return;
+        }
+
+        m_counts.clear();
+        m_firsts.clear();
+        m_offsets.clear();
+        m_base_vertices.clear();
+        for (int i{}; i < count; i++)
+        {
+            m_counts.push_back(items[i]->count);
+            m_firsts.push_back(static_cast<GLint>(items[i]->first));
+            m_offsets.push_back(reinterpret_cast<const void*>(items[i]->first));
+            m_base_vertices.push_back(items[i]->base_vertex);
+        }
+
+        if (item.index_type == GL_NONE)
+        {
+            gltk_GLCheck(glMultiDrawArrays(item.mode, m_firsts.data(), m_counts.data(), count));
+        }
+        else
+        {
+            gltk_GLCheck(glMultiDrawElementsBaseVertex(item.mode, m_counts.data(), item.index_type, m_offsets.data(), count, m_base_vertices.data()));
+        }
+        m_stats.draw_calls++;
+        m_stats.multi_draws++;
+    }
+}
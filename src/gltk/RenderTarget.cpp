@@ -0,0 +1,48 @@
+#include <gltk/RenderTarget.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+namespace gltk
+{
+    RenderTarget::RenderTarget(int width, int height)
+        : m_width{ width }
+        , m_height{ height }
+        , m_framebuffer{}
+        , m_color{}
+        , m_depth_stencil{}
+    {
+        gltk_Check(m_width > 0 && m_height > 0);
+
+        gltk_GLCheck(glGenTextures(1, &m_color));
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, m_color));
+        gltk_GLCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+        gltk_GLCheck(glGenRenderbuffers(1, &m_depth_stencil));
+        gltk_GLCheck(glBindRenderbuffer(GL_RENDERBUFFER, m_depth_stencil));
+        gltk_GLCheck(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height));
+        gltk_GLCheck(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+        gltk_GLCheck(glGenFramebuffers(1, &m_framebuffer));
+        gltk_GLCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer));
+        gltk_GLCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_color, 0));
+        gltk_GLCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth_stencil));
+        GLenum status{};
+        gltk_GLCheck(status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+        gltk_GLCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+        gltk_Check(status == GL_FRAMEBUFFER_COMPLETE);
+    }
+    RenderTarget::~RenderTarget()
+    {
+        gltk_GLCheck(glDeleteFramebuffers(1, &m_framebuffer));
+        gltk_GLCheck(glDeleteRenderbuffers(1, &m_depth_stencil));
+        gltk_GLCheck(glDeleteTextures(1, &m_color));
+    }
+    void RenderTarget::Bind()
+    {
+        gltk_GLCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer));
+        gltk_GLCheck(glViewport(0, 0, m_width, m_height));
+    }
+}
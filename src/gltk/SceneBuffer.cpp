@@ -0,0 +1,337 @@
+#include <gltk/SceneBuffer.h>
+#include <gltk/Check.h>
+#include <gltk/Frustum.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GLTK_SCENE_BUFFER_SSE 1
+#endif
+
+namespace gltk
+{
+    static auto GroupTuple(const SceneMesh& mesh)
+    {
+        return std::tuple{ mesh.vao, mesh.mode, mesh.index_type };
+    }
+    static GLintptr IndexSize(GLenum index_type)
+    {
+        switch (index_type)
+        {
+        case GL_UNSIGNED_BYTE: { return 1; }
+        case GL_UNSIGNED_SHORT: { return 2; }
+        case GL_UNSIGNED_INT: { return 4; }
+        default: { gltk_Unreachable(); }
+        }
+    }
+
+    SceneBuffer::SceneBuffer(ThreadPool* pool, bool allow_indirect, GLsizeiptr stream_size)
+        : m_pool{ pool }
+        , m_state{}
+        , m_transform_stream{ GL_ARRAY_BUFFER, stream_size }
+        , m_commands{}
+        , m_meshes{}
+        , m_mesh_order{}
+        , m_mesh_order_dirty{}
+        , m_mesh_visible{}
+        , m_mesh_first{}
+        , m_center_x{}
+        , m_center_y{}
+        , m_center_z{}
+        , m_radius{}
+        , m_transforms{}
+        , m_instance_mesh{}
+        , m_visible{}
+        , m_planes{}
+        , m_stats{}
+    {
+        // the per-draw baseInstance of the commands is how each mesh finds its transforms, so both are needed
+        if (allow_indirect && GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance)
+        {
+            m_commands.emplace(GL_DRAW_INDIRECT_BUFFER, stream_size / 4);
+        }
+    }
+    std::uint32_t SceneBuffer::AddMesh(const SceneMesh& mesh)
+    {
+        gltk_Check(mesh.vao && mesh.count > 0 && mesh.first % IndexSize(mesh.index_type) == 0);
+        m_meshes.push_back(mesh);
+        std::uint32_t idx{ static_cast<std::uint32_t>(m_meshes.size() - 1) };
+
+        m_mesh_order.push_back(idx);
+        m_mesh_order_dirty = true;
+        m_mesh_visible.push_back(0);
+        m_mesh_first.push_back(0);
+        return idx;
+    }
+    std::uint32_t SceneBuffer::AddInstance(std::uint32_t mesh, const glm::mat4& transform)
+    {
+        gltk_Check(mesh < m_meshes.size());
+        m_center_x.push_back(0.0f);
+        m_center_y.push_back(0.0f);
+        m_center_z.push_back(0.0f);
+        m_radius.push_back(0.0f);
+        m_transforms.push_back({});
+        m_instance_mesh.push_back(mesh);
+        m_visible.push_back(0);
+
+        std::uint32_t instance{ InstanceCount() - 1 };
+        SetTransform(instance, transform);
+        return instance;
+    }
+    void SceneBuffer::SetTransform(std::uint32_t instance, const glm::mat4& transform)
+    {
+        gltk_Check(instance < InstanceCount());
+        const SceneMesh& mesh{ m_meshes[m_instance_mesh[instance]] };
+
+        // the sphere is scaled by the largest axis scale, so it still bounds the mesh under non-uniform scaling
+        glm::vec3 center{ transform * glm::vec4{ mesh.center, 1.0f } };
+        float scale_sq{ std::max({ glm::dot(glm::vec3{ transform[0] }, glm::vec3{ transform[0] }),
+            glm::dot(glm::vec3{ transform[1] }, glm::vec3{ transform[1] }),
+            glm::dot(glm::vec3{ transform[2] }, glm::vec3{ transform[2] }) }) };
+        m_center_x[instance] = center.x;
+        m_center_y[instance] = center.y;
+        m_center_z[instance] = center.z;
+        m_radius[instance] = mesh.radius * std::sqrt(scale_sq);
+        m_transforms[instance] = transform;
+    }
+    void SceneBuffer::Cull(const glm::mat4& view_proj)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+
+        ExtractFrustumPlanes(view_proj, m_planes);
+
+        std::uint32_t batches{ (InstanceCount() + BATCH_SIZE - 1) / BATCH_SIZE };
+        if (m_pool && batches > 1)
+        {
+            // batches are claimed from a shared counter, so the calling thread keeps culling when the workers are
+            // busy, and a job that only starts after Cull returned finds nothing left and touches nothing but job
+            struct Job
+            {
+                std::atomic<std::uint32_t> next;
+                std::atomic<std::uint32_t> done;
+                std::uint32_t batches;
+            };
+            auto job{ std::make_shared<Job>() };
+            job->batches = batches;
+            auto work{ [this, job]()
+            {
+                for (std::uint32_t batch{}; (batch = job->next.fetch_add(1)) < job->batches;)
+                {
+                    CullBatch(batch);
+                    if (job->done.fetch_add(1) + 1 == job->batches)
+                    {
+                        job->done.notify_all();
+                    }
+                }
+            } };
+
+            int helpers{ std::min(m_pool->ThreadCount(), static_cast<int>(batches) - 1) };
+            for (int i{}; i < helpers; i++)
+            {
+                m_pool->Submit(work);
+            }
+            work();
+            for (std::uint32_t done{}; (done = job->done.load()) < batches;)
+            {
+                job->done.wait(done);
+            }
+        }
+        else
+        {
+            for (std::uint32_t batch{}; batch < batches; batch++)
+            {
+                CullBatch(batch);
+            }
+        }
+
+        std::ranges::fill(m_mesh_visible, 0);
+        int visible{};
+        for (std::uint32_t i{}; i < InstanceCount(); i++)
+        {
+            m_mesh_visible[m_instance_mesh[i]] += m_visible[i];
+            visible += m_visible[i];
+        }
+
+        m_stats.instances = static_cast<int>(InstanceCount());
+        m_stats.visible = visible;
+        m_stats.batches = static_cast<int>(batches);
+        m_stats.indirect = Indirect();
+        m_stats.cull_time = std::chrono::steady_clock::now() - start;
+    }
+    void SceneBuffer::Draw(GLuint program)
+    {
+        gltk_ProfileZone("SceneBuffer::Draw");
+        auto start{ std::chrono::steady_clock::now() };
+
+        // sorted once for all the meshes added since the last draw, rather than on every AddMesh
+        if (m_mesh_order_dirty)
+        {
+            std::ranges::stable_sort(m_mesh_order, [this](std::uint32_t a, std::uint32_t b) { return GroupTuple(m_meshes[a]) < GroupTuple(m_meshes[b]); });
+            m_mesh_order_dirty = false;
+        }
+
+        m_stats.draw_calls = 0;
+        m_stats.commands = 0;
+        if (m_stats.visible > 0)
+        {
+            // whatever ran since the last draw may have changed the bindings
+            m_state.Invalidate();
+            m_state.ResetStats();
+            m_state.UseProgram(program);
+
+            // transforms of the visible instances, grouped by mesh in draw order
+            std::uint32_t first{};
+            for (std::uint32_t mesh : m_mesh_order)
+            {
+                m_mesh_first[mesh] = first;
+                first += m_mesh_visible[mesh];
+            }
+            StreamRange range{ m_transform_stream.Map(m_stats.visible * sizeof(glm::mat4), sizeof(glm::mat4)) };
+            glm::mat4* transforms{ static_cast<glm::mat4*>(range.data) };
+            for (std::uint32_t i{}; i < InstanceCount(); i++)
+            {
+                if (m_visible[i])
+                {
+                    transforms[m_mesh_first[m_instance_mesh[i]]++] = m_transforms[i];
+                }
+            }
+            m_transform_stream.Unmap(range);
+            for (std::uint32_t mesh{}; mesh < m_meshes.size(); mesh++)
+            {
+                m_mesh_first[mesh] -= m_mesh_visible[mesh];
+            }
+
+            for (auto begin{ m_mesh_order.begin() }; begin != m_mesh_order.end();)
+            {
+                const SceneMesh& head{ m_meshes[*begin] };
+                auto end{ std::find_if(begin, m_mesh_order.end(), [&](std::uint32_t mesh) { return GroupTuple(m_meshes[mesh]) != GroupTuple(head); }) };
+                int drawn{ static_cast<int>(std::count_if(begin, end, [this](std::uint32_t mesh) { return m_mesh_visible[mesh] > 0; })) };
+                if (drawn == 0)
+                {
+                    begin = end;
+                    continue;
+                }
+
+                m_state.BindVertexArray(head.vao);
+                if (m_commands)
+                {
+                    StreamRange command_range{ m_commands->Map(drawn * sizeof(DrawElementsIndirectCommand), sizeof(GLuint)) };
+                    DrawElementsIndirectCommand* commands{ static_cast<DrawElementsIndirectCommand*>(command_range.data) };
+                    for (auto it{ begin }; it != end; it++)
+                    {
+                        if (m_mesh_visible[*it] > 0)
+                        {
+                            const SceneMesh& mesh{ m_meshes[*it] };
+                            *commands++ = {
+                                .count = static_cast<GLuint>(mesh.count),
+                                .instance_count = m_mesh_visible[*it],
+                                .first_index = static_cast<GLuint>(mesh.first / IndexSize(mesh.index_type)),
+                                .base_vertex = mesh.base_vertex,
+                                .base_instance = m_mesh_first[*it],
+                            };
+                        }
+                    }
+                    m_commands->Unmap(command_range);
+
+                    BindTransforms(range.offset);
+                    gltk_GLCheck(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commands->Buffer()));
+                    gltk_GLCheck(glMultiDrawElementsIndirect(head.mode, head.index_type, reinterpret_cast<const void*>(command_range.offset), drawn, 0));
+                    m_stats.draw_calls++;
+                    m_stats.commands += drawn;
+                }
+                else
+                {
+                    // without base instance, the attributes have to be pointed at the transforms of each mesh
+                    for (auto it{ begin }; it != end; it++)
+                    {
+                        if (m_mesh_visible[*it] > 0)
+                        {
+                            const SceneMesh& mesh{ m_meshes[*it] };
+                            BindTransforms(range.offset + m_mesh_first[*it] * sizeof(glm::mat4));
+                            gltk_GLCheck(glDrawElementsInstancedBaseVertex(mesh.mode, mesh.count, mesh.index_type,
+                                reinterpret_cast<const void*>(mesh.first), static_cast<GLsizei>(m_mesh_visible[*it]), mesh.base_vertex));
+                            m_stats.draw_calls++;
+                            m_stats.commands++;
+                        }
+                    }
+                }
+                begin = end;
+            }
+        }
+
+        m_transform_stream.EndFrame();
+        if (m_commands)
+        {
+            m_commands->EndFrame();
+        }
+        m_stats.draw_time = std::chrono::steady_clock::now() - start;
+    }
+    void SceneBuffer::CullBatch(std::uint32_t batch)
+    {
+        std::uint32_t i{ batch * BATCH_SIZE };
+        std::uint32_t end{ std::min(i + BATCH_SIZE, InstanceCount()) };
+        const float* cx{ m_center_x.data() };
+        const float* cy{ m_center_y.data() };
+        const float* cz{ m_center_z.data() };
+        const float* r{ m_radius.data() };
+        std::uint8_t* visible{ m_visible.data() };
+
+        #if defined(GLTK_SCENE_BUFFER_SSE)
+        // four spheres against one plane at a time
+        __m128 px[6], py[6], pz[6], pw[6];
+        for (int p{}; p < 6; p++)
+        {
+            px[p] = _mm_set1_ps(m_planes[p].x);
+            py[p] = _mm_set1_ps(m_planes[p].y);
+            pz[p] = _mm_set1_ps(m_planes[p].z);
+            pw[p] = _mm_set1_ps(m_planes[p].w);
+        }
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 x{ _mm_loadu_ps(cx + i) };
+            __m128 y{ _mm_loadu_ps(cy + i) };
+            __m128 z{ _mm_loadu_ps(cz + i) };
+            __m128 neg_r{ _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(r + i)) };
+            __m128 inside{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+            for (int p{}; p < 6; p++)
+            {
+                __m128 distance{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, px[p]), _mm_mul_ps(y, py[p])), _mm_add_ps(_mm_mul_ps(z, pz[p]), pw[p])) };
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_r));
+            }
+            int mask{ _mm_movemask_ps(inside) };
+            visible[i + 0] = static_cast<std::uint8_t>(mask & 1);
+            visible[i + 1] = static_cast<std::uint8_t>((mask >> 1) & 1);
+            visible[i + 2] = static_cast<std::uint8_t>((mask >> 2) & 1);
+            visible[i + 3] = static_cast<std::uint8_t>((mask >> 3) & 1);
+        }
+        #endif
+
+        for (; i < end; i++)
+        {
+            bool inside{ true };
+            for (const glm::vec4& plane : m_planes)
+            {
+                inside &= plane.x * cx[i] + plane.y * cy[i] + plane.z * cz[i] + plane.w >= -r[i];
+            }
+            visible[i] = inside;
+        }
+    }
+    void SceneBuffer::BindTransforms(GLintptr offset)
+    {
+        m_state.BindArrayBuffer(m_transform_stream.Buffer());
+        for (GLuint column{}; column < 4; column++)
+        {
+            gltk_GLCheck(glEnableVertexAttribArray(TRANSFORM_ATTRIB + column));
+            gltk_GLCheck(glVertexAttribPointer(TRANSFORM_ATTRIB + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                reinterpret_cast<const void*>(offset + column * sizeof(glm::vec4))));
+            gltk_GLCheck(glVertexAttribDivisor(TRANSFORM_ATTRIB + column, 1));
+        }
+    }
+}
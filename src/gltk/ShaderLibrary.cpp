@@ -0,0 +1,399 @@
+#include <gltk/ShaderLibrary.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Hash.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace gltk
+{
+    namespace
+    {
+        std::filesystem::path Normalize(const std::filesystem::path& path)
+        {
+            std::error_code ec{};
+            std::filesystem::path normalized{ std::filesystem::weakly_canonical(path, ec) };
+            return ec ? path.lexically_normal() : normalized;
+        }
+
+        bool ReadFile(const std::filesystem::path& path, std::string& contents)
+        {
+            std::ifstream file{ path, std::ios::binary };
+            if (!file)
+            {
+                return false;
+            }
+            std::ostringstream stream{};
+            stream << file.rdbuf();
+            contents = std::move(stream).str();
+            return true;
+        }
+
+        std::uint64_t HashFile(const std::filesystem::path& path)
+        {
+            std::string contents{};
+            return ReadFile(path, contents) ? HashBytes(FNV_OFFSET_BASIS, contents.data(), contents.size()) : 0;
+        }
+
+        std::string_view Trim(std::string_view str)
+        {
+            std::size_t begin{ str.find_first_not_of(" \t\r") };
+            if (begin == std::string_view::npos)
+            {
+                return {};
+            }
+            std::size_t end{ str.find_last_not_of(" \t\r") };
+            return str.substr(begin, end - begin + 1);
+        }
+
+        std::size_t DependencyIdx(std::vector<std::filesystem::path>& dependencies, const std::filesystem::path& file)
+        {
+            auto it{ std::find(dependencies.begin(), dependencies.end(), file) };
+            if (it == dependencies.end())
+            {
+                dependencies.push_back(file);
+                return dependencies.size() - 1;
+            }
+            return static_cast<std::size_t>(it - dependencies.begin());
+        }
+    }
+
+    ShaderLibrary::ShaderLibrary(const std::filesystem::path& root, ProgramCache* cache)
+        : m_root{ Normalize(root) }
+        , m_builder{ cache }
+        , m_programs{}
+        , m_files{}
+        , m_watch_fd{ -1 }
+        , m_watch_dirs{}
+        , m_last_poll{ std::chrono::steady_clock::now() }
+        , m_stats{}
+    {
+        #if defined(__linux__)
+        m_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC); // stays -1 on failure, which falls back to polling
+        #endif
+    }
+    ShaderLibrary::~ShaderLibrary()
+    {
+        for (const std::shared_ptr<ShaderProgram::State>& state : m_programs)
+        {
+            if (state->program)
+            {
+                gltk_GLCheck(glDeleteProgram(state->program));
+            }
+            // builds that are still running get cancelled by the builder, finished ones are ours
+            if (GLuint program{ state->pending.Program() })
+            {
+                gltk_GLCheck(glDeleteProgram(program));
+            }
+        }
+
+        #if defined(__linux__)
+        if (m_watch_fd >= 0)
+        {
+            close(m_watch_fd);
+        }
+        #endif
+    }
+    ShaderProgram ShaderLibrary::Load(const std::string& name, const ShaderFiles& files)
+    {
+        auto state{ std::make_shared<ShaderProgram::State>() };
+        state->name = name;
+        state->files.vertex = Normalize(m_root / files.vertex);
+        state->files.geometry = files.geometry.empty() ? std::filesystem::path{} : Normalize(m_root / files.geometry);
+        state->files.fragment = Normalize(m_root / files.fragment);
+
+        Build(*state);
+        m_programs.push_back(state);
+        return ShaderProgram{ state };
+    }
+    int ShaderLibrary::Update()
+    {
+        m_builder.Poll();
+        for (const std::shared_ptr<ShaderProgram::State>& state : m_programs)
+        {
+            Harvest(*state);
+        }
+
+        std::vector<std::filesystem::path> changed{ ChangedFiles() };
+        if (!changed.empty())
+        {
+            for (const std::shared_ptr<ShaderProgram::State>& state : m_programs)
+            {
+                bool affected{ std::ranges::any_of(state->dependencies, [&](const std::filesystem::path& dependency)
+                {
+                    return std::ranges::find(changed, dependency) != changed.end();
+                }) };
+                if (affected)
+                {
+                    Build(*state);
+                }
+            }
+        }
+
+        return m_builder.Pending();
+    }
+    void ShaderLibrary::Build(ShaderProgram::State& state)
+    {
+        const std::filesystem::path* stage_files[]{ &state.files.vertex, &state.files.geometry, &state.files.fragment };
+        std::string sources[3]{};
+        std::vector<std::filesystem::path> dependencies{};
+        std::string error{};
+        bool success{ true };
+        for (int i{}; i < 3 && success; i++)
+        {
+            if (!stage_files[i]->empty())
+            {
+                std::vector<std::filesystem::path> included{};
+                success = Expand(*stage_files[i], sources[i], dependencies, included, error);
+            }
+        }
+
+        // watch whatever was reached, even on failure, so that fixing the file triggers a rebuild
+        for (const std::filesystem::path& dependency : dependencies)
+        {
+            Watch(dependency);
+        }
+        state.dependencies = std::move(dependencies);
+
+        if (!success)
+        {
+            state.error = std::format("{}: {}", state.name, error);
+            m_stats.failures++;
+            return;
+        }
+
+        std::uint64_t hash{ FNV_OFFSET_BASIS };
+        for (const std::string& source : sources)
+        {
+            std::uint64_t size{ source.size() };
+            hash = HashBytes(hash, &size, sizeof(size));
+            hash = HashBytes(hash, source.data(), source.size());
+        }
+        if (state.pending.Valid())
+        {
+            if (hash != state.pending_hash)
+            {
+                state.dirty = true; // rebuilt once the pending build is harvested
+            }
+            return;
+        }
+        if (state.program && hash == state.sources_hash)
+        {
+            state.error.clear(); // back to the sources of the current program
+            m_stats.skipped++;
+            return;
+        }
+
+        state.pending_hash = hash;
+        state.pending = m_builder.Submit({ .vertex = sources[0], .geometry = sources[1], .fragment = sources[2] });
+        m_stats.builds++;
+    }
+    void ShaderLibrary::Harvest(ShaderProgram::State& state)
+    {
+        if (!state.pending.Ready())
+        {
+            return;
+        }
+
+        if (GLuint program{ state.pending.Program() })
+        {
+            if (state.program)
+            {
+                gltk_GLCheck(glDeleteProgram(state.program));
+            }
+            state.program = program;
+            state.sources_hash = state.pending_hash;
+            state.generation++;
+            state.error.clear();
+            m_stats.swaps++;
+        }
+        else
+        {
+            // keep the previous program, and say which source string number is which file
+            state.error = std::format("{}: {}", state.name, state.pending.InfoLog());
+            for (std::size_t i{}; i < state.dependencies.size(); i++)
+            {
+                state.error += std::format("\n  source string {}: {}", i, state.dependencies[i].string());
+            }
+            m_stats.failures++;
+        }
+        state.pending = {};
+
+        if (state.dirty)
+        {
+            state.dirty = false;
+            Build(state);
+        }
+    }
+    bool ShaderLibrary::Expand(const std::filesystem::path& file, std::string& out, std::vector<std::filesystem::path>& dependencies,
+        std::vector<std::filesystem::path>& included, std::string& error) const
+    {
+        included.push_back(file);
+        std::size_t file_idx{ DependencyIdx(dependencies, file) };
+
+        std::string contents{};
+        if (!ReadFile(file, contents))
+        {
+            error = std::format("cannot open '{}'", file.string());
+            return false;
+        }
+
+        std::string_view text{ contents };
+        for (int line_no{ 1 }; !text.empty(); line_no++)
+        {
+            std::size_t eol{ text.find('\n') };
+            std::string_view line{ text.substr(0, eol) };
+            text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+
+            std::string_view directive{ Trim(line) };
+            if (directive.starts_with("#version"))
+            {
+                // #line may not come before #version, so the stage file gets its own source string number only here
+                out += line;
+                out += std::format("\n#line {} {}\n", line_no + 1, file_idx);
+                continue;
+            }
+            if (!directive.starts_with("#include"))
+            {
+                out += line;
+                out += '\n';
+                continue;
+            }
+
+            std::string_view name{ Trim(directive.substr(std::string_view{ "#include" }.size())) };
+            if (name.size() < 2 || name.front() != '"' || name.back() != '"')
+            {
+                error = std::format("{}({}): malformed #include", file.string(), line_no);
+                return false;
+            }
+            name = name.substr(1, name.size() - 2);
+
+            std::filesystem::path include{ file.parent_path() / name };
+            if (!std::filesystem::exists(include))
+            {
+                include = m_root / name;
+            }
+            include = Normalize(include);
+
+            // each file is expanded once per stage, which also breaks include cycles
+            if (std::ranges::find(included, include) != included.end())
+            {
+                out += '\n';
+                continue;
+            }
+
+            out += std::format("#line 1 {}\n", DependencyIdx(dependencies, include));
+            if (!Expand(include, out, dependencies, included, error))
+            {
+                error = std::format("{}\n  included from {}({})", error, file.string(), line_no);
+                return false;
+            }
+            out += std::format("#line {} {}\n", line_no + 1, file_idx);
+        }
+        return true;
+    }
+    void ShaderLibrary::Watch(const std::filesystem::path& file)
+    {
+        if (m_files.contains(file.string()))
+        {
+            return;
+        }
+
+        std::error_code ec{};
+        WatchedFile watched{};
+        watched.hash = HashFile(file);
+        watched.write_time = std::filesystem::last_write_time(file, ec);
+        m_files.emplace(file.string(), watched);
+
+        #if defined(__linux__)
+        if (m_watch_fd >= 0)
+        {
+            // watch the directory rather than the file, editors often save by writing a new file and renaming it
+            std::filesystem::path dir{ file.parent_path() };
+            int wd{ inotify_add_watch(m_watch_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) };
+            if (wd >= 0)
+            {
+                m_watch_dirs[wd] = dir; // adding the same directory again returns the same descriptor
+            }
+        }
+        #endif
+    }
+    std::vector<std::filesystem::path> ShaderLibrary::ChangedFiles()
+    {
+        std::vector<std::filesystem::path> candidates{};
+
+        #if defined(__linux__)
+        if (m_watch_fd >= 0)
+        {
+            alignas(inotify_event) char buffer[4096];
+            for (ssize_t size{}; (size = read(m_watch_fd, buffer, sizeof(buffer))) > 0;)
+            {
+                for (char* ptr{ buffer }; ptr < buffer + size;)
+                {
+                    const inotify_event* event{ reinterpret_cast<const inotify_event*>(ptr) };
+                    auto dir{ m_watch_dirs.find(event->wd) };
+                    if (event->len > 0 && dir != m_watch_dirs.end())
+                    {
+                        candidates.push_back(dir->second / event->name);
+                    }
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        else
+        #endif
+        {
+            auto now{ std::chrono::steady_clock::now() };
+            if (now - m_last_poll >= POLL_INTERVAL)
+            {
+                m_last_poll = now;
+                for (const auto& [path, watched] : m_files)
+                {
+                    std::error_code ec{};
+                    if (std::filesystem::last_write_time(path, ec) != watched.write_time || ec)
+                    {
+                        candidates.push_back(path);
+                    }
+                }
+            }
+        }
+
+        std::ranges::sort(candidates);
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        m_stats.file_events += static_cast<int>(candidates.size());
+
+        // only keep the files whose contents actually changed
+        std::vector<std::filesystem::path> changed{};
+        for (const std::filesystem::path& candidate : candidates)
+        {
+            auto it{ m_files.find(candidate.string()) };
+            if (it == m_files.end())
+            {
+                continue;
+            }
+
+            std::error_code ec{};
+            it->second.write_time = std::filesystem::last_write_time(candidate, ec);
+            std::uint64_t hash{ HashFile(candidate) };
+            if (hash != it->second.hash)
+            {
+                it->second.hash = hash;
+                changed.push_back(candidate);
+            }
+            else
+            {
+                m_stats.skipped++;
+            }
+        }
+        return changed;
+    }
+}
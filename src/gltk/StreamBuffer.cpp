@@ -0,0 +1,141 @@
+#include <gltk/StreamBuffer.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+namespace gltk
+{
+    StreamBuffer::StreamBuffer(GLenum target, GLsizeiptr capacity)
+        : m_target{ target }
+        , m_capacity{ capacity }
+        , m_buffer{}
+        , m_persistent{}
+        , m_head{}
+        , m_frame_begin{}
+        , m_fences{}
+        , m_stats{}
+    {
+        gltk_Check(m_capacity > 0);
+
+        gltk_GLCheck(glGenBuffers(1, &m_buffer));
+        gltk_GLCheck(glBindBuffer(m_target, m_buffer));
+        if (GLAD_GL_ARB_buffer_storage)
+        {
+            GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+            gltk_GLCheck(glBufferStorage(m_target, m_capacity, nullptr, flags));
+            gltk_GLCheck(m_persistent = static_cast<char*>(glMapBufferRange(m_target, 0, m_capacity, flags)));
+            gltk_Check(m_persistent);
+        }
+        else
+        {
+            gltk_GLCheck(glBufferData(m_target, m_capacity, nullptr, GL_STREAM_DRAW));
+        }
+        // not left bound: a bound pixel unpack buffer turns the client pointers of later texture uploads into offsets
+        gltk_GLCheck(glBindBuffer(m_target, 0));
+    }
+    StreamBuffer::~StreamBuffer()
+    {
+        for (const Fence& fence : m_fences)
+        {
+            gltk_GLCheck(glDeleteSync(fence.sync));
+        }
+        if (m_persistent)
+        {
+            gltk_GLCheck(glBindBuffer(m_target, m_buffer));
+            gltk_GLCheck(glUnmapBuffer(m_target));
+            gltk_GLCheck(glBindBuffer(m_target, 0));
+        }
+        gltk_GLCheck(glDeleteBuffers(1, &m_buffer));
+    }
+    StreamRange StreamBuffer::Map(GLsizeiptr size, GLsizeiptr alignment)
+    {
+        gltk_Check(size > 0 && alignment > 0);
+
+        // align the offset inside the ring rather than the monotonic position, which differ once the ring has
+        // wrapped and alignment does not divide the capacity, and skip the end of the ring when the range would
+        // straddle it
+        std::uint64_t offset{ m_head % m_capacity };
+        std::uint64_t aligned{ (offset + alignment - 1) / alignment * alignment };
+        std::uint64_t begin{ m_head - offset + aligned };
+        if (aligned + size > static_cast<std::uint64_t>(m_capacity))
+        {
+            begin = m_head - offset + m_capacity;
+        }
+        std::uint64_t end{ begin + size };
+        gltk_Check(end - m_frame_begin <= static_cast<std::uint64_t>(m_capacity)); // one frame must fit in the ring
+
+        WaitForRange(end);
+        m_head = end;
+
+        StreamRange range{};
+        range.offset = static_cast<GLintptr>(begin % m_capacity);
+        range.size = size;
+        if (m_persistent)
+        {
+            range.data = m_persistent + range.offset;
+        }
+        else
+        {
+            // the fences already guarantee the GPU is done with this range, so the driver must not synchronize
+            GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_INVALIDATE_RANGE_BIT };
+            gltk_GLCheck(glBindBuffer(m_target, m_buffer));
+            gltk_GLCheck(range.data = glMapBufferRange(m_target, range.offset, range.size, flags));
+            gltk_Check(range.data);
+            gltk_GLCheck(glBindBuffer(m_target, 0));
+        }
+
+        m_stats.maps++;
+        m_stats.bytes += size;
+        return range;
+    }
+    void StreamBuffer::Unmap(const StreamRange& range)
+    {
+        if (m_persistent)
+        {
+            return; // coherent mapping, writes are visible to subsequent commands
+        }
+
+        gltk_GLCheck(glBindBuffer(m_target, m_buffer));
+        gltk_GLCheck(glFlushMappedBufferRange(m_target, 0, range.size));
+        gltk_GLCheck(glUnmapBuffer(m_target));
+        gltk_GLCheck(glBindBuffer(m_target, 0));
+    }
+    void StreamBuffer::EndFrame()
+    {
+        if (m_head == m_frame_begin)
+        {
+            return;
+        }
+
+        GLsync sync{};
+        gltk_GLCheck(sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_fences.push_back({ m_frame_begin, sync });
+        m_frame_begin = m_head;
+    }
+    void StreamBuffer::WaitForRange(std::uint64_t end)
+    {
+        // the range aliases whatever was written one ring earlier, so every frame that started before that is waited on
+        while (!m_fences.empty() && m_fences.front().begin + m_capacity < end)
+        {
+            Fence fence{ m_fences.front() };
+            m_fences.pop_front();
+
+            m_stats.fence_checks++;
+            GLenum status{};
+            gltk_GLCheck(status = glClientWaitSync(fence.sync, 0, 0));
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                m_stats.fence_waits++;
+                auto start{ std::chrono::steady_clock::now() };
+                while (status == GL_TIMEOUT_EXPIRED)
+                {
+                    constexpr GLuint64 TIMEOUT_NS{ 1'000'000'000 };
+                    gltk_GLCheck(status = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT_NS));
+                }
+                m_stats.wait_time += std::chrono::steady_clock::now() - start;
+            }
+            gltk_Check(status != GL_WAIT_FAILED);
+
+            gltk_GLCheck(glDeleteSync(fence.sync));
+        }
+    }
+}
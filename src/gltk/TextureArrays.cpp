@@ -0,0 +1,475 @@
+#include <gltk/TextureArrays.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <scope_guard.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <map>
+#include <utility>
+
+namespace gltk
+{
+    static int LevelCount(int width, int height)
+    {
+        return std::bit_width(static_cast<unsigned>(std::max(width, height)));
+    }
+    static std::int64_t MipChainBytes(int width, int height, int levels)
+    {
+        std::int64_t bytes{};
+        for (int level{}; level < levels; level++)
+        {
+            bytes += static_cast<std::int64_t>(std::max(1, width >> level)) * std::max(1, height >> level) * 4;
+        }
+        return bytes;
+    }
+
+    AtlasPacker::AtlasPacker(int width, int height)
+        : m_width{ width }
+        , m_height{ height }
+        , m_used_area{}
+        , m_skyline{}
+    {
+        Clear();
+    }
+    std::optional<AtlasRect> AtlasPacker::Insert(int width, int height)
+    {
+        std::size_t best_idx{ m_skyline.size() };
+        int best_top{ INT_MAX };
+        int best_segment_width{ INT_MAX };
+        for (std::size_t i{}; i < m_skyline.size(); i++)
+        {
+            if (m_skyline[i].x + width > m_width)
+            {
+                break;
+            }
+            int top{ Fit(i, width) + height };
+            if (top > m_height)
+            {
+                continue;
+            }
+            // lowest top first, then the tightest segment to keep the skyline flat
+            if (top < best_top || (top == best_top && m_skyline[i].width < best_segment_width))
+            {
+                best_idx = i;
+                best_top = top;
+                best_segment_width = m_skyline[i].width;
+            }
+        }
+        if (best_idx == m_skyline.size())
+        {
+            return std::nullopt;
+        }
+
+        AtlasRect rect{ m_skyline[best_idx].x, best_top - height, width, height };
+        m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(best_idx), { rect.x, best_top, width });
+
+        // cut the segments now under the new one
+        for (std::size_t i{ best_idx + 1 }; i < m_skyline.size();)
+        {
+            int covered_end{ m_skyline[i - 1].x + m_skyline[i - 1].width };
+            Segment& segment{ m_skyline[i] };
+            if (segment.x >= covered_end)
+            {
+                break;
+            }
+            int overlap{ covered_end - segment.x };
+            segment.x += overlap;
+            segment.width -= overlap;
+            if (segment.width > 0)
+            {
+                break;
+            }
+            m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        // merge neighbors at the same height
+        for (std::size_t i{}; i + 1 < m_skyline.size();)
+        {
+            if (m_skyline[i].y == m_skyline[i + 1].y)
+            {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        m_used_area += static_cast<std::int64_t>(width) * height;
+        return rect;
+    }
+    void AtlasPacker::Clear()
+    {
+        m_used_area = 0;
+        m_skyline.assign(1, { 0, 0, m_width });
+    }
+    int AtlasPacker::Fit(std::size_t idx, int width) const
+    {
+        int end{ m_skyline[idx].x + width };
+        int y{};
+        for (std::size_t i{ idx }; i < m_skyline.size() && m_skyline[i].x < end; i++)
+        {
+            y = std::max(y, m_skyline[i].y);
+        }
+        return y;
+    }
+
+    TextureArrays::TextureArrays()
+        : m_read_fbo{}
+        , m_draw_fbo{}
+        , m_regions{}
+        , m_pending{}
+        , m_textures{}
+        , m_atlas_area{}
+        , m_atlas_capacity{}
+        , m_stats{}
+    {
+        gltk_GLCheck(glGenFramebuffers(1, &m_read_fbo));
+        gltk_GLCheck(glGenFramebuffers(1, &m_draw_fbo));
+    }
+    TextureArrays::~TextureArrays()
+    {
+        gltk_GLCheck(glDeleteTextures(static_cast<GLsizei>(m_textures.size()), m_textures.data()));
+        gltk_GLCheck(glDeleteFramebuffers(1, &m_draw_fbo));
+        gltk_GLCheck(glDeleteFramebuffers(1, &m_read_fbo));
+    }
+    int TextureArrays::Add(GLuint texture, bool atlas)
+    {
+        gltk_Check(texture);
+        GLint width{};
+        GLint height{};
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, texture));
+        gltk_GLCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width));
+        gltk_GLCheck(glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height));
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+        m_regions.push_back({});
+        m_pending.push_back({ static_cast<int>(m_regions.size() - 1), width, height, texture, {}, atlas });
+        return m_pending.back().region;
+    }
+    int TextureArrays::Add(const TextureAsset& texture, bool atlas)
+    {
+        gltk_Check(texture.Stage() == TextureStage::Ready);
+        return Add(texture.Texture(), atlas);
+    }
+    int TextureArrays::Add(int width, int height, std::span<const unsigned char> rgba, bool atlas)
+    {
+        gltk_Check(width > 0 && height > 0 && rgba.size() == static_cast<std::size_t>(width) * height * 4);
+        m_regions.push_back({});
+        m_pending.push_back({ static_cast<int>(m_regions.size() - 1), width, height, 0, { rgba.begin(), rgba.end() }, atlas });
+        return m_pending.back().region;
+    }
+    void TextureArrays::Build()
+    {
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        // blits go through the framebuffers below and honor the scissor test, uploads read the unpack buffer
+        GLint previous_read_fbo{};
+        GLint previous_draw_fbo{};
+        GLint previous_unpack_buffer{};
+        GLboolean previous_scissor{};
+        gltk_GLCheck(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_read_fbo));
+        gltk_GLCheck(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_draw_fbo));
+        gltk_GLCheck(glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previous_unpack_buffer));
+        gltk_GLCheck(previous_scissor = glIsEnabled(GL_SCISSOR_TEST));
+        auto restore_state_on_exit{ sg::make_scope_guard([=]()
+        {
+            gltk_GLCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(previous_read_fbo)));
+            gltk_GLCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previous_draw_fbo)));
+            gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(previous_unpack_buffer)));
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+            if (previous_scissor)
+            {
+                gltk_GLCheck(glEnable(GL_SCISSOR_TEST));
+            }
+        }) };
+        gltk_GLCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_read_fbo));
+        gltk_GLCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_draw_fbo));
+        gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        gltk_GLCheck(glDisable(GL_SCISSOR_TEST));
+
+        std::vector<const PendingImage*> atlased{};
+        std::map<std::pair<int, int>, std::vector<const PendingImage*>> by_size{};
+        for (const PendingImage& image : m_pending)
+        {
+            if (image.atlas && image.width <= MAX_ATLAS_IMAGE && image.height <= MAX_ATLAS_IMAGE)
+            {
+                atlased.push_back(&image);
+            }
+            else
+            {
+                by_size[{ image.width, image.height }].push_back(&image);
+            }
+            m_stats.separate_bytes += MipChainBytes(image.width, image.height, LevelCount(image.width, image.height));
+        }
+
+        // atlas layers: tallest images first, each into the first layer where it fits; padded sizes are rounded to
+        // the smallest level's texel so that every image starts on a texel boundary on every level
+        if (!atlased.empty())
+        {
+            constexpr int ALIGNMENT{ 1 << (ATLAS_LEVELS - 1) };
+            auto padded{ [](int size) { return (size + 2 * PADDING + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; } };
+            std::stable_sort(atlased.begin(), atlased.end(), [](const PendingImage* a, const PendingImage* b) { return a->height > b->height; });
+
+            // first fit into layers of the given size, nullopt past max_layers
+            using Placements = std::vector<std::pair<int, AtlasRect>>;
+            auto pack{ [&](int size, int max_layers, int& layer_count) -> std::optional<Placements>
+            {
+                std::vector<AtlasPacker> layers{};
+                Placements placements{};
+                for (const PendingImage* image : atlased)
+                {
+                    std::optional<AtlasRect> rect{};
+                    int layer{};
+                    for (; layer < static_cast<int>(layers.size()); layer++)
+                    {
+                        if ((rect = layers[layer].Insert(padded(image->width), padded(image->height))))
+                        {
+                            break;
+                        }
+                    }
+                    if (!rect)
+                    {
+                        if (static_cast<int>(layers.size()) == max_layers)
+                        {
+                            return std::nullopt;
+                        }
+                        layers.emplace_back(size, size);
+                        if (!(rect = layers.back().Insert(padded(image->width), padded(image->height))))
+                        {
+                            return std::nullopt; // larger than a whole layer of this size
+                        }
+                    }
+                    placements.push_back({ layer, *rect });
+                }
+                layer_count = static_cast<int>(layers.size());
+                return placements;
+            } };
+
+            // a set that fits a single layer gets the smallest square one it fits in (in SIZE_STEP steps, starting
+            // from its padded area and its largest padded image), trimmed to the height it uses, to not waste a full
+            // size layer
+            constexpr int SIZE_STEP{ 64 };
+            std::int64_t padded_area{};
+            int padded_max{};
+            for (const PendingImage* image : atlased)
+            {
+                padded_area += static_cast<std::int64_t>(padded(image->width)) * padded(image->height);
+                padded_max = std::max({ padded_max, padded(image->width), padded(image->height) });
+            }
+            int start_size{ std::max(static_cast<int>(std::ceil(std::sqrt(static_cast<double>(padded_area)))), padded_max) };
+            start_size = (start_size + SIZE_STEP - 1) / SIZE_STEP * SIZE_STEP;
+            int atlas_w{ ATLAS_SIZE };
+            int atlas_h{ ATLAS_SIZE };
+            int layer_count{};
+            std::optional<Placements> placements{};
+            for (int size{ std::max(start_size, MIN_ATLAS_SIZE) }; size < ATLAS_SIZE && !placements; size += SIZE_STEP)
+            {
+                if ((placements = pack(size, 1, layer_count)))
+                {
+                    int top{};
+                    for (const auto& [layer, rect] : *placements)
+                    {
+                        top = std::max(top, rect.y + rect.height);
+                    }
+                    atlas_w = size;
+                    atlas_h = top;
+                }
+            }
+            if (!placements)
+            {
+                placements = pack(ATLAS_SIZE, INT_MAX, layer_count);
+            }
+
+            GLuint array{ CreateArray(atlas_w, atlas_h, layer_count, ATLAS_LEVELS, GL_CLAMP_TO_EDGE) };
+            for (std::size_t i{}; i < atlased.size(); i++)
+            {
+                const PendingImage& image{ *atlased[i] };
+                auto [layer, rect] { (*placements)[i] };
+                int x{ rect.x + PADDING };
+                int y{ rect.y + PADDING };
+                CopyImage(image, array, layer, x, y, PADDING);
+
+                float w{ static_cast<float>(atlas_w) };
+                float h{ static_cast<float>(atlas_h) };
+                m_regions[image.region] = { array, layer, glm::vec4{ x / w, y / h, image.width / w, image.height / h } };
+                m_atlas_area += static_cast<std::int64_t>(image.width) * image.height;
+            }
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, array));
+            gltk_GLCheck(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+
+            m_atlas_capacity += static_cast<std::int64_t>(atlas_w) * atlas_h * layer_count;
+            m_stats.atlased += static_cast<int>(atlased.size());
+            m_stats.layers += layer_count;
+            m_stats.bytes += MipChainBytes(atlas_w, atlas_h, ATLAS_LEVELS) * layer_count;
+        }
+
+        // one array per image size, a layer per image
+        for (const auto& [size, images] : by_size)
+        {
+            auto [width, height] { size };
+            int levels{ LevelCount(width, height) };
+            GLuint array{ CreateArray(width, height, static_cast<int>(images.size()), levels, GL_REPEAT) };
+            for (int layer{}; layer < static_cast<int>(images.size()); layer++)
+            {
+                CopyImage(*images[layer], array, layer, 0, 0, 0);
+                m_regions[images[layer]->region] = { array, layer, glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f } };
+            }
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, array));
+            gltk_GLCheck(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+
+            m_stats.layers += static_cast<int>(images.size());
+            m_stats.bytes += MipChainBytes(width, height, levels) * static_cast<std::int64_t>(images.size());
+        }
+
+        m_stats.images += static_cast<int>(m_pending.size());
+        m_stats.arrays = static_cast<int>(m_textures.size());
+        m_stats.atlas_occupancy = m_atlas_capacity > 0 ? static_cast<float>(static_cast<double>(m_atlas_area) / static_cast<double>(m_atlas_capacity)) : 0.0f;
+        m_pending.clear();
+    }
+    GLuint TextureArrays::CreateArray(int width, int height, int layers, int levels, GLint wrap)
+    {
+        GLuint array{};
+        gltk_GLCheck(glGenTextures(1, &array));
+        m_textures.push_back(array);
+        gltk_GLCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, array));
+        for (int level{}; level < levels; level++)
+        {
+            gltk_GLCheck(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, width >> level), std::max(1, height >> level), layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+        }
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap));
+        gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap));
+        return array;
+    }
+    void TextureArrays::CopyImage(const PendingImage& image, GLuint array, int layer, int x, int y, int padding)
+    {
+        int x1{ x + image.width };
+        int y1{ y + image.height };
+
+        // the padding is filled from the source rather than from the layer, which would read what was just written
+        if (!image.texture)
+        {
+            const unsigned char* pixels{ image.pixels.data() };
+            std::vector<unsigned char> padded{};
+            if (padding > 0)
+            {
+                int padded_w{ image.width + 2 * padding };
+                int padded_h{ image.height + 2 * padding };
+                padded.resize(static_cast<std::size_t>(padded_w) * padded_h * 4);
+                for (int row{}; row < padded_h; row++)
+                {
+                    int src_row{ std::clamp(row - padding, 0, image.height - 1) };
+                    for (int col{}; col < padded_w; col++)
+                    {
+                        int src_col{ std::clamp(col - padding, 0, image.width - 1) };
+                        std::memcpy(&padded[(static_cast<std::size_t>(row) * padded_w + col) * 4], &pixels[(static_cast<std::size_t>(src_row) * image.width + src_col) * 4], 4);
+                    }
+                }
+                pixels = padded.data();
+            }
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D_ARRAY, array));
+            gltk_GLCheck(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, x - padding, y - padding, layer, image.width + 2 * padding, image.height + 2 * padding, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+            return;
+        }
+
+        gltk_GLCheck(glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, image.texture, 0));
+        gltk_GLCheck(glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, array, 0, layer));
+        gltk_Check(glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        gltk_Check(glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        auto blit{ [](int src_x0, int src_y0, int src_x1, int src_y1, int dst_x0, int dst_y0, int dst_x1, int dst_y1)
+        {
+            gltk_GLCheck(glBlitFramebuffer(src_x0, src_y0, src_x1, src_y1, dst_x0, dst_y0, dst_x1, dst_y1, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+        } };
+        int w{ image.width };
+        int h{ image.height };
+        blit(0, 0, w, h, x, y, x1, y1);
+        if (padding > 0)
+        {
+            // edge rows, columns and corners stretched over the padding
+            blit(0, 0, 1, h, x - padding, y, x, y1);
+            blit(w - 1, 0, w, h, x1, y, x1 + padding, y1);
+            blit(0, 0, w, 1, x, y - padding, x1, y);
+            blit(0, h - 1, w, h, x, y1, x1, y1 + padding);
+            blit(0, 0, 1, 1, x - padding, y - padding, x, y);
+            blit(w - 1, 0, w, 1, x1, y - padding, x1 + padding, y);
+            blit(0, h - 1, 1, h, x - padding, y1, x, y1 + padding);
+            blit(w - 1, h - 1, w, h, x1, y1, x1 + padding, y1 + padding);
+        }
+    }
+
+    std::vector<int> AddGltfMaterials(TextureArrays& arrays, const GltfAsset& asset)
+    {
+        gltk_Check(asset.Stage() == AssetStage::Ready);
+        const tinygltf::Model& model{ asset.Model() };
+
+        // an image can go into the atlas unless some primitive samples it out of [0, 1] with a repeating sampler
+        std::vector<bool> repeats(model.images.size(), false);
+        for (const tinygltf::Mesh& mesh : model.meshes)
+        {
+            for (const tinygltf::Primitive& primitive : mesh.primitives)
+            {
+                if (primitive.material < 0)
+                {
+                    continue;
+                }
+                const tinygltf::TextureInfo& info{ model.materials[primitive.material].pbrMetallicRoughness.baseColorTexture };
+                if (info.index < 0 || model.textures[info.index].source < 0)
+                {
+                    continue;
+                }
+                const tinygltf::Texture& texture{ model.textures[info.index] };
+                bool clamps{ texture.sampler >= 0
+                    && model.samplers[texture.sampler].wrapS == TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE
+                    && model.samplers[texture.sampler].wrapT == TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE };
+
+                bool in_unit_square{};
+                auto uv{ primitive.attributes.find(std::format("TEXCOORD_{}", info.texCoord)) };
+                if (uv != primitive.attributes.end())
+                {
+                    const tinygltf::Accessor& accessor{ model.accessors[uv->second] };
+                    in_unit_square = accessor.minValues.size() == 2 && accessor.maxValues.size() == 2
+                        && accessor.minValues[0] >= 0.0 && accessor.minValues[1] >= 0.0 && accessor.maxValues[0] <= 1.0 && accessor.maxValues[1] <= 1.0;
+                }
+                if (!clamps && !in_unit_square)
+                {
+                    repeats[texture.source] = true;
+                }
+            }
+        }
+
+        std::vector<int> image_regions(model.images.size(), -1);
+        std::vector<int> material_regions(model.materials.size(), -1);
+        for (std::size_t i{}; i < model.materials.size(); i++)
+        {
+            int texture{ model.materials[i].pbrMetallicRoughness.baseColorTexture.index };
+            if (texture < 0)
+            {
+                continue;
+            }
+            int source{ model.textures[texture].source };
+            if (source < 0 || !asset.Textures()[source])
+            {
+                continue;
+            }
+            if (image_regions[source] < 0)
+            {
+                image_regions[source] = arrays.Add(asset.Textures()[source], !repeats[source]);
+            }
+            material_regions[i] = image_regions[source];
+        }
+        return material_regions;
+    }
+}
@@ -0,0 +1,363 @@
+#include <gltk/TextureLoader.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+#include <gltk/Hash.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+
+namespace gltk
+{
+    namespace
+    {
+        constexpr char ENTRY_MAGIC[8]{ 'G', 'L', 'T', 'K', 'T', 'X', '0', '1' };
+
+        struct EntryHeader
+        {
+            char magic[8];
+            std::uint64_t key;
+            std::int32_t width;
+            std::int32_t height;
+            std::int32_t levels;
+            std::int32_t reserved;
+        };
+
+        constexpr std::size_t BYTES_PER_PIXEL{ 4 };
+        constexpr GLsizeiptr MAX_ROW_BYTES{ 16384 * BYTES_PER_PIXEL }; // a row of the widest texture GL implementations allow
+
+        int LevelCount(int width, int height)
+        {
+            return std::bit_width(static_cast<unsigned>(std::max(width, height)));
+        }
+
+        int LevelSize(int size, int level)
+        {
+            return std::max(size >> level, 1);
+        }
+
+        std::size_t LevelBytes(int width, int height, int level)
+        {
+            return static_cast<std::size_t>(LevelSize(width, level)) * LevelSize(height, level) * BYTES_PER_PIXEL;
+        }
+
+        std::size_t TotalBytes(int width, int height, int levels)
+        {
+            std::size_t total{};
+            for (int level{}; level < levels; level++)
+            {
+                total += LevelBytes(width, height, level);
+            }
+            return total;
+        }
+
+        // 2x2 box filter, odd edges reuse their last row/column
+        void Downsample(const unsigned char* src, int src_w, int src_h, unsigned char* dst, int dst_w, int dst_h)
+        {
+            for (int y{}; y < dst_h; y++)
+            {
+                int y0{ std::min(2 * y, src_h - 1) };
+                int y1{ std::min(2 * y + 1, src_h - 1) };
+                for (int x{}; x < dst_w; x++)
+                {
+                    int x0{ std::min(2 * x, src_w - 1) };
+                    int x1{ std::min(2 * x + 1, src_w - 1) };
+                    for (std::size_t c{}; c < BYTES_PER_PIXEL; c++)
+                    {
+                        unsigned sum{};
+                        sum += src[(static_cast<std::size_t>(y0) * src_w + x0) * BYTES_PER_PIXEL + c];
+                        sum += src[(static_cast<std::size_t>(y0) * src_w + x1) * BYTES_PER_PIXEL + c];
+                        sum += src[(static_cast<std::size_t>(y1) * src_w + x0) * BYTES_PER_PIXEL + c];
+                        sum += src[(static_cast<std::size_t>(y1) * src_w + x1) * BYTES_PER_PIXEL + c];
+                        dst[(static_cast<std::size_t>(y) * dst_w + x) * BYTES_PER_PIXEL + c] = static_cast<unsigned char>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+    }
+
+    TextureLoader::TextureLoader(ThreadPool& pool, const std::filesystem::path& cache_dir, GLsizeiptr staging_capacity)
+        : m_pool{ pool }
+        , m_cache_dir{ cache_dir }
+        , m_staging{ GL_PIXEL_UNPACK_BUFFER, staging_capacity }
+        , m_pending{}
+        , m_shared_stats{ std::make_shared<SharedStats>() }
+        , m_bytes_uploaded{}
+    {
+        gltk_Check(staging_capacity >= 2 * MAX_ROW_BYTES); // Update must always be able to upload at least a row
+
+        // a missing cache directory only means every load is a miss
+        std::error_code ec{};
+        std::filesystem::create_directories(m_cache_dir, ec);
+    }
+    TextureLoaderStats TextureLoader::Stats() const noexcept
+    {
+        TextureLoaderStats stats{};
+        stats.cache_hits = m_shared_stats->cache_hits.load(std::memory_order_relaxed);
+        stats.cache_misses = m_shared_stats->cache_misses.load(std::memory_order_relaxed);
+        stats.cache_writes = m_shared_stats->cache_writes.load(std::memory_order_relaxed);
+        stats.bytes_uploaded = m_bytes_uploaded;
+        return stats;
+    }
+    TextureAsset TextureLoader::Load(const std::filesystem::path& path)
+    {
+        auto state{ std::make_shared<TextureAsset::State>() };
+        state->path = path;
+        state->stage.store(TextureStage::Loading, std::memory_order_relaxed);
+        state->start_time = std::chrono::steady_clock::now();
+
+        m_pending.push_back(state);
+        m_pool.Submit([cache_dir = m_cache_dir, stats = m_shared_stats, state]() { LoadLevels(cache_dir, *stats, *state); });
+        return TextureAsset{ state };
+    }
+    int TextureLoader::Update(GLsizeiptr max_bytes)
+    {
+        // everything mapped between two EndFrame calls must fit in the ring, including the space skipped on wrap,
+        // and at least a row must fit in the budget or the upload would never progress
+        GLsizeiptr budget{ std::min(std::max(max_bytes, MAX_ROW_BYTES), m_staging.Capacity() / 2) };
+        GLsizeiptr used{};
+        for (auto it{ m_pending.begin() }; it != m_pending.end();)
+        {
+            TextureAsset::State& state{ **it };
+            TextureStage stage{ state.stage.load(std::memory_order_acquire) };
+            if (stage == TextureStage::Uploading && used < budget)
+            {
+                used += Upload(state, budget - used);
+                if (state.next_level < state.levels)
+                {
+                    break; // out of budget
+                }
+
+                state.levels_data = {};
+                state.mapping.reset();
+                state.pixels = {};
+                state.timings.total = std::chrono::steady_clock::now() - state.start_time;
+                state.stage.store(TextureStage::Ready, std::memory_order_release);
+                it = m_pending.erase(it);
+            }
+            else if (stage == TextureStage::Failed)
+            {
+                it = m_pending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (used > 0)
+        {
+            gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
+            m_staging.EndFrame();
+            m_bytes_uploaded += used;
+        }
+        return Pending();
+    }
+    void TextureLoader::Unload(TextureAsset& asset)
+    {
+        gltk_Check(asset.Valid() && asset.Stage() == TextureStage::Ready);
+        gltk_GLCheck(glDeleteTextures(1, &asset.m_state->texture));
+        asset = {};
+    }
+    void TextureLoader::LoadLevels(const std::filesystem::path& cache_dir, SharedStats& stats, TextureAsset::State& state)
+    {
+        // entries are addressed by path, size and modification time, so editing the source invalidates them
+        std::error_code ec{};
+        std::uint64_t file_size{ std::filesystem::file_size(state.path, ec) };
+        std::filesystem::file_time_type write_time{};
+        if (!ec)
+        {
+            write_time = std::filesystem::last_write_time(state.path, ec);
+        }
+        if (ec)
+        {
+            state.error = std::format("{}: {}", state.path.string(), ec.message());
+            state.timings.total = std::chrono::steady_clock::now() - state.start_time;
+            state.stage.store(TextureStage::Failed, std::memory_order_release);
+            return;
+        }
+
+        std::string path_str{ state.path.generic_string() };
+        std::int64_t write_ticks{ write_time.time_since_epoch().count() };
+        std::uint64_t key{ HashBytes(FNV_OFFSET_BASIS, path_str.data(), path_str.size()) };
+        key = HashBytes(key, &file_size, sizeof(file_size));
+        key = HashBytes(key, &write_ticks, sizeof(write_ticks));
+        std::filesystem::path entry_path{ cache_dir / std::format("{:016x}.tex", key) };
+
+        if (LoadFromCache(entry_path, key, state))
+        {
+            state.from_cache = true;
+            stats.cache_hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            stats.cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+            int w{};
+            int h{};
+            int comp{};
+            stbi_uc* pixels{ stbi_load(state.path.string().c_str(), &w, &h, &comp, static_cast<int>(BYTES_PER_PIXEL)) };
+            if (!pixels)
+            {
+                state.error = std::format("{}: {}", state.path.string(), stbi_failure_reason());
+                state.timings.total = std::chrono::steady_clock::now() - state.start_time;
+                state.stage.store(TextureStage::Failed, std::memory_order_release);
+                return;
+            }
+
+            state.width = w;
+            state.height = h;
+            state.levels = LevelCount(w, h);
+            state.pixels.resize(TotalBytes(w, h, state.levels));
+            std::memcpy(state.pixels.data(), pixels, LevelBytes(w, h, 0));
+            stbi_image_free(pixels);
+
+            unsigned char* src{ state.pixels.data() };
+            for (int level{ 1 }; level < state.levels; level++)
+            {
+                unsigned char* dst{ src + LevelBytes(w, h, level - 1) };
+                Downsample(src, LevelSize(w, level - 1), LevelSize(h, level - 1), dst, LevelSize(w, level), LevelSize(h, level));
+                src = dst;
+            }
+            state.levels_data = state.pixels;
+
+            if (WriteToCache(entry_path, key, state))
+            {
+                stats.cache_writes.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // rows are uploaded whole, so a wider texture would never fit in the budget
+        if (static_cast<GLsizeiptr>(state.width * BYTES_PER_PIXEL) > MAX_ROW_BYTES)
+        {
+            state.error = std::format("{}: {} pixels wide, more than {}", state.path.string(), state.width, MAX_ROW_BYTES / BYTES_PER_PIXEL);
+            state.timings.total = std::chrono::steady_clock::now() - state.start_time;
+            state.stage.store(TextureStage::Failed, std::memory_order_release);
+            return;
+        }
+
+        state.loaded_time = std::chrono::steady_clock::now();
+        state.timings.load = state.loaded_time - state.start_time;
+        state.stage.store(TextureStage::Uploading, std::memory_order_release);
+    }
+    bool TextureLoader::LoadFromCache(const std::filesystem::path& entry_path, std::uint64_t key, TextureAsset::State& state)
+    {
+        auto mapping{ std::make_unique<MappedFile>(entry_path) };
+        if (!mapping->Valid() || mapping->Size() < sizeof(EntryHeader))
+        {
+            return false;
+        }
+
+        EntryHeader header{};
+        std::memcpy(&header, mapping->Data().data(), sizeof(header));
+        if (std::memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0 || header.key != key
+            || header.width <= 0 || header.height <= 0 || header.levels != LevelCount(header.width, header.height)
+            || mapping->Size() != sizeof(EntryHeader) + TotalBytes(header.width, header.height, header.levels))
+        {
+            return false;
+        }
+
+        state.width = header.width;
+        state.height = header.height;
+        state.levels = header.levels;
+        state.levels_data = { reinterpret_cast<const unsigned char*>(mapping->Data().data() + sizeof(EntryHeader)), mapping->Size() - sizeof(EntryHeader) };
+        state.mapping = std::move(mapping);
+        return true;
+    }
+    bool TextureLoader::WriteToCache(const std::filesystem::path& entry_path, std::uint64_t key, const TextureAsset::State& state)
+    {
+        EntryHeader header{};
+        std::memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+        header.key = key;
+        header.width = state.width;
+        header.height = state.height;
+        header.levels = state.levels;
+
+        // write next to the final entry and rename, so that a crash never leaves a truncated entry behind
+        std::filesystem::path tmp_path{ entry_path };
+        tmp_path += ".tmp";
+        {
+            std::ofstream file{ tmp_path, std::ios::binary | std::ios::trunc };
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(state.levels_data.data()), static_cast<std::streamsize>(state.levels_data.size()));
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(tmp_path, entry_path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+        return true;
+    }
+    GLsizeiptr TextureLoader::Upload(TextureAsset::State& state, GLsizeiptr budget)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+
+        if (!state.texture)
+        {
+            state.timings.wait = start - state.loaded_time;
+
+            // allocate every level up front, with no unpack buffer bound so that nothing is read
+            gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+            gltk_GLCheck(glGenTextures(1, &state.texture));
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, state.texture));
+            for (int level{}; level < state.levels; level++)
+            {
+                gltk_GLCheck(glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, LevelSize(state.width, level), LevelSize(state.height, level), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+            }
+            gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, state.levels - 1));
+            gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR));
+            gltk_GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        }
+        else
+        {
+            gltk_GLCheck(glBindTexture(GL_TEXTURE_2D, state.texture));
+        }
+
+        std::size_t level_offset{ TotalBytes(state.width, state.height, state.next_level) };
+        GLsizeiptr used{};
+        while (state.next_level < state.levels)
+        {
+            int w{ LevelSize(state.width, state.next_level) };
+            int h{ LevelSize(state.height, state.next_level) };
+            GLsizeiptr row_bytes{ static_cast<GLsizeiptr>(w * BYTES_PER_PIXEL) };
+            int rows{ static_cast<int>(std::min<GLsizeiptr>(h - state.next_row, (budget - used) / row_bytes)) };
+            if (rows <= 0)
+            {
+                break;
+            }
+
+            // the copy into the stream buffer is the only synchronous part, the transfer to the texture is not
+            GLsizeiptr size{ rows * row_bytes };
+            StreamRange range{ m_staging.Map(size, BYTES_PER_PIXEL) };
+            std::memcpy(range.data, state.levels_data.data() + level_offset + state.next_row * row_bytes, size);
+            m_staging.Unmap(range);
+
+            gltk_GLCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_staging.Buffer()));
+            gltk_GLCheck(glTexSubImage2D(GL_TEXTURE_2D, state.next_level, 0, state.next_row, w, rows, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(range.offset)));
+
+            used += size;
+            state.next_row += rows;
+            if (state.next_row == h)
+            {
+                level_offset += static_cast<std::size_t>(row_bytes) * h;
+                state.next_level++;
+                state.next_row = 0;
+            }
+        }
+
+        state.timings.upload += std::chrono::steady_clock::now() - start;
+        return used;
+    }
+}
@@ -0,0 +1,59 @@
+#include <gltk/ThreadPool.h>
+#include <gltk/Check.h>
+
+#include <algorithm>
+
+namespace gltk
+{
+    ThreadPool::ThreadPool(int thread_count)
+        : m_mutex{}
+        , m_cv{}
+        , m_jobs{}
+        , m_threads{}
+    {
+        gltk_Check(thread_count > 0);
+        m_threads.reserve(thread_count);
+        for (int i{}; i < thread_count; i++)
+        {
+            m_threads.emplace_back([this](std::stop_token stop) { Run(stop); });
+        }
+    }
+    ThreadPool::~ThreadPool()
+    {
+        for (std::jthread& thread : m_threads)
+        {
+            thread.request_stop();
+        }
+        m_threads.clear(); // joins
+    }
+    int ThreadPool::DefaultThreadCount()
+    {
+        // leave one hardware thread to the thread owning the OpenGL context
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    void ThreadPool::Submit(Job job)
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_jobs.push_back(std::move(job));
+        }
+        m_cv.notify_one();
+    }
+    void ThreadPool::Run(std::stop_token stop)
+    {
+        while (true)
+        {
+            Job job{};
+            {
+                std::unique_lock lock{ m_mutex };
+                if (!m_cv.wait(lock, stop, [this]() { return !m_jobs.empty(); }))
+                {
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include <gltk/UniformBuffer.h>
+#include <gltk/Check.h>
+#include <gltk/GLCheck.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace gltk
+{
+    std::vector<UniformBlockInfo> ReflectUniformBlocks(GLuint program)
+    {
+        int block_count{};
+        int max_name_length{};
+        gltk_GLCheck(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &block_count));
+        gltk_GLCheck(glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_name_length));
+
+        std::vector<UniformBlockInfo> blocks(block_count);
+        std::string name(std::max(max_name_length, 1), '\0');
+        for (int i{}; i < block_count; i++)
+        {
+            UniformBlockInfo& block{ blocks[i] };
+            GLsizei length{};
+            gltk_GLCheck(glGetActiveUniformBlockName(program, i, static_cast<GLsizei>(name.size()), &length, name.data()));
+            block.name.assign(name.data(), length);
+            block.index = static_cast<GLuint>(i);
+            gltk_GLCheck(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_BINDING, &block.binding));
+            gltk_GLCheck(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.size));
+
+            int member_count{};
+            gltk_GLCheck(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &member_count));
+            std::vector<GLint> indices(member_count);
+            if (member_count > 0)
+            {
+                gltk_GLCheck(glGetActiveUniformBlockiv(program, i, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data()));
+            }
+
+            int max_member_name_length{};
+            gltk_GLCheck(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_member_name_length));
+            std::string member_name(std::max(max_member_name_length, 1), '\0');
+            for (GLint index : indices)
+            {
+                GLuint uniform{ static_cast<GLuint>(index) };
+                GLsizei member_name_length{};
+                GLint offset{};
+                gltk_GLCheck(glGetActiveUniformName(program, uniform, static_cast<GLsizei>(member_name.size()), &member_name_length, member_name.data()));
+                gltk_GLCheck(glGetActiveUniformsiv(program, 1, &uniform, GL_UNIFORM_OFFSET, &offset));
+                block.members.push_back({ std::string{ member_name.data(), static_cast<std::size_t>(member_name_length) }, offset });
+            }
+            std::ranges::sort(block.members, {}, &UniformBlockMember::offset);
+        }
+        return blocks;
+    }
+    bool BindUniformBlock(GLuint program, const char* block_name, GLuint binding)
+    {
+        GLuint index{};
+        gltk_GLCheck(index = glGetUniformBlockIndex(program, block_name));
+        if (index == GL_INVALID_INDEX)
+        {
+            return false;
+        }
+        gltk_GLCheck(glUniformBlockBinding(program, index, binding));
+        return true;
+    }
+
+    UniformBuffer::UniformBuffer(GLsizeiptr size)
+        : m_size{ size }
+        , m_buffer{}
+        , m_shadow(size)
+        , m_dirty{}
+        , m_stats{}
+    {
+        gltk_Check(m_size > 0);
+
+        gltk_GLCheck(glGenBuffers(1, &m_buffer));
+        gltk_GLCheck(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer));
+        gltk_GLCheck(glBufferData(GL_UNIFORM_BUFFER, m_size, m_shadow.data(), GL_DYNAMIC_DRAW));
+        gltk_GLCheck(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    }
+    UniformBuffer::~UniformBuffer()
+    {
+        gltk_GLCheck(glDeleteBuffers(1, &m_buffer));
+    }
+    void UniformBuffer::Write(GLintptr offset, const void* data, GLsizeiptr size)
+    {
+        gltk_Check(offset >= 0 && size >= 0 && offset + size <= m_size);
+
+        m_stats.writes++;
+        unsigned char* dst{ m_shadow.data() + offset };
+        if (std::memcmp(dst, data, size) == 0)
+        {
+            m_stats.unchanged_writes++;
+            return;
+        }
+        std::memcpy(dst, data, size);
+        MarkDirty(offset, offset + size);
+    }
+    void UniformBuffer::Upload()
+    {
+        if (m_dirty.empty())
+        {
+            return;
+        }
+
+        gltk_GLCheck(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer));
+        for (const auto& [begin, end] : m_dirty)
+        {
+            gltk_GLCheck(glBufferSubData(GL_UNIFORM_BUFFER, begin, end - begin, m_shadow.data() + begin));
+            m_stats.upload_calls++;
+            m_stats.upload_bytes += end - begin;
+        }
+        gltk_GLCheck(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+        m_dirty.clear();
+    }
+    void UniformBuffer::BindBase(GLuint binding)
+    {
+        gltk_GLCheck(glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_buffer));
+    }
+    void UniformBuffer::MarkDirty(GLintptr begin, GLintptr end)
+    {
+        // insert in order, then absorb the neighbours that overlap or are within MERGE_GAP
+        auto it{ std::ranges::lower_bound(m_dirty, begin, {}, &std::pair<GLintptr, GLintptr>::first) };
+        it = m_dirty.insert(it, { begin, end });
+        if (it != m_dirty.begin() && std::prev(it)->second + MERGE_GAP >= it->first)
+        {
+            --it;
+            it->second = std::max(it->second, std::next(it)->second);
+            m_dirty.erase(std::next(it));
+        }
+        while (std::next(it) != m_dirty.end() && it->second + MERGE_GAP >= std::next(it)->first)
+        {
+            it->second = std::max(it->second, std::next(it)->second);
+            m_dirty.erase(std::next(it));
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include <tiny_gltf.h>
+
+#include <gltk/GLTK.h>
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string>
+
+// Offline mesh preprocessing: extracts every triangle primitive of a glTF file, optimizes it for the vertex cache,
+// overdraw and vertex fetch, and writes it as a mesh file (see gltk/MeshFile.h) named
+// <output_dir>/<stem>_<mesh>_<primitive>.gltkmesh, printing ACMR and size statistics along the way.
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: gltk_mesh_tool <file.gltf|file.glb> <output_dir>\n";
+        return 1;
+    }
+    std::filesystem::path input_path{ argv[1] };
+    std::filesystem::path output_dir{ argv[2] };
+
+    try
+    {
+        // images are not needed, keep them encoded
+        tinygltf::TinyGLTF gltf{};
+        gltf.SetImagesAsIs(true);
+        tinygltf::Model model{};
+        std::string err{};
+        std::string warn{};
+        bool loaded{ input_path.extension() == ".glb"
+            ? gltf.LoadBinaryFromFile(&model, &err, &warn, input_path.string())
+            : gltf.LoadASCIIFromFile(&model, &err, &warn, input_path.string()) };
+        if (!loaded)
+        {
+            std::cerr << std::format("[MESH]: failed to load '{}': {}\n", input_path.string(), err);
+            return 1;
+        }
+
+        std::error_code ec{};
+        std::filesystem::create_directories(output_dir, ec);
+
+        gltk::MeshStats total{};
+        int written{};
+        int failed{};
+        std::cout << std::format("{:<40} {:>9} {:>9} {:>13} {:>13} {:>11} {:>11} {:>9}\n",
+            "mesh", "vertices", "triangles", "acmr before", "acmr after", "in KiB", "out KiB", "ms");
+        for (std::size_t mesh_idx{}; mesh_idx < model.meshes.size(); mesh_idx++)
+        {
+            const tinygltf::Mesh& mesh{ model.meshes[mesh_idx] };
+            for (std::size_t primitive_idx{}; primitive_idx < mesh.primitives.size(); primitive_idx++)
+            {
+                std::string name{ std::format("{}_{}_{}", input_path.stem().string(), mesh_idx, primitive_idx) };
+                gltk::MeshData data{};
+                std::string error{};
+                if (!gltk::ExtractGltfPrimitive(model, mesh.primitives[primitive_idx], data, error))
+                {
+                    std::cerr << std::format("[MESH]: skipping {}: {}\n", name, error);
+                    failed++;
+                    continue;
+                }
+
+                gltk::MeshStats stats{ gltk::OptimizeMesh(data) };
+                std::filesystem::path output_path{ output_dir / (name + ".gltkmesh") };
+                if (!gltk::WriteMeshFile(output_path, data))
+                {
+                    std::cerr << std::format("[MESH]: failed to write '{}'\n", output_path.string());
+                    failed++;
+                    continue;
+                }
+                written++;
+
+                std::cout << std::format("{:<40} {:>9} {:>9} {:>13.3f} {:>13.3f} {:>11.1f} {:>11.1f} {:>9.2f}\n",
+                    name, stats.vertices, stats.triangles, stats.before.acmr, stats.after.acmr,
+                    static_cast<double>(stats.input_bytes) / 1024.0, static_cast<double>(stats.output_bytes) / 1024.0,
+                    std::chrono::duration<double, std::milli>(stats.time).count());
+
+                total.vertices += stats.vertices;
+                total.triangles += stats.triangles;
+                total.before.acmr += stats.before.acmr * static_cast<float>(stats.triangles);
+                total.after.acmr += stats.after.acmr * static_cast<float>(stats.triangles);
+                total.input_bytes += stats.input_bytes;
+                total.output_bytes += stats.output_bytes;
+                total.time += stats.time;
+            }
+        }
+
+        float triangles{ static_cast<float>(std::max<std::uint32_t>(total.triangles, 1)) };
+        std::cout << std::format("{:<40} {:>9} {:>9} {:>13.3f} {:>13.3f} {:>11.1f} {:>11.1f} {:>9.2f}\n",
+            std::format("total ({} written, {} failed)", written, failed), total.vertices, total.triangles,
+            total.before.acmr / triangles, total.after.acmr / triangles,
+            static_cast<double>(total.input_bytes) / 1024.0, static_cast<double>(total.output_bytes) / 1024.0,
+            std::chrono::duration<double, std::milli>(total.time).count());
+        return failed == 0 ? 0 : 1;
+    }
+    catch (const gltk::Crash& e)
+    {
+        std::cerr << e.What() << '\n';
+        return 1;
+    }
+}